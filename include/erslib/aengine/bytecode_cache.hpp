@@ -0,0 +1,99 @@
+#pragma once
+
+// std
+#include <filesystem>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+
+// sol
+#include <sol/state_view.hpp>
+
+// ers
+#include <erslib/aengine/mod.hpp>
+#include <erslib/core/fwd.hpp>
+#include <erslib/core/type/general.hpp>
+#include <erslib/core/type/version.hpp>
+
+
+// On-disk cache of compiled Lua chunks of mods.
+//
+// One file per (mod, path) keeps the "lua_dump" output behind a header with the mod version and the
+// RapidHash of the source it was compiled from. A chunk is taken from the cache only if all of them
+// match, otherwise it's compiled from text and the file is rewritten. Headers are checked when the
+// cache is opened, files of another format or Lua version are removed right away.
+//
+// The directory must not be writable by mods: binary chunks bypass the Lua compiler checks.
+
+namespace aengine::impl {
+    class BytecodeCache {
+    public:
+        static constexpr u32 format_version = 1;
+
+
+        // Constructor
+
+        explicit BytecodeCache(fs::path dir);
+
+
+        // Modifiers
+
+        // Same as "lua.load(source, chunk_name)", "path" is the chunk's path inside of the mod.
+        sol::load_result load(
+            sol::state_view& lua,
+            const ModIdentity& mod,
+            std::string_view path,
+            std::string_view source,
+            const std::string& chunk_name
+        );
+
+
+        // Observers
+
+        [[nodiscard]]
+        size_t size() const;
+
+        [[nodiscard]]
+        const fs::path& dir() const noexcept { return m_dir; }
+
+
+    private:
+        struct header_t {
+            char magic[4];
+            u32 format;
+            u32 lua_version;
+            u32 reserved;
+            u64 major;
+            u64 minor;
+            u64 patch;
+            u64 content_hash;
+            u64 size;
+        };
+
+        struct entry_t {
+            ers::version_t version;
+            u64 content_hash;
+        };
+
+
+        [[nodiscard]]
+        fs::path _path_of(u64 id) const;
+
+        bool _read(u64 id, const entry_t& expected, std::string& out) const;
+        void _write(u64 id, const entry_t& entry, std::string_view bytecode);
+
+
+        fs::path m_dir;
+
+        mutable std::shared_mutex m_mutex;
+        // Ids are hashes already.
+        ers::TrivialMap<entry_t> m_entries;
+    };
+}
+
+
+// Exports
+
+namespace aengine {
+    using impl::BytecodeCache;
+}
@@ -1,12 +1,17 @@
 #pragma once
 
 // std
+#include <filesystem>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <span>
 
 // ers
+#include <erslib/aengine/dependency.hpp>
 #include <erslib/aengine/mod.hpp>
+#include <erslib/core/fwd.hpp>
+#include <erslib/core/type/general.hpp>
 
 
 namespace aengine::impl {
@@ -15,15 +20,162 @@ namespace aengine::impl {
         std::string phase;
         size_t index;
     };
+
+    // Same as above, but viewing names owned by mods and orders.
+    struct stage_ref_t {
+        std::string_view mod;
+        std::string_view phase;
+        size_t index;
+    };
+
+
+    // Stages of one mod within a "stage_group_t", in the order they run.
+    struct mod_stages_t {
+        std::string mod;
+        std::vector<size_t> indexes;
+    };
+
+    // Mods of one phase without a dependency path between them, they may run concurrently.
+    // Groups run one after another, mods inside are listed in the resolved mods order.
+    struct stage_group_t {
+        std::string phase;
+        std::vector<mod_stages_t> mods;
+    };
 }
 
 namespace aengine::impl {
-    std::vector<std::string> resolve_mods_order(const ModContainer& mods, std::string_view initial_mod);
+    // Graph of mods over dense ids, every name is interned once and is never copied afterwards.
+    //
+    // The resolved order is cached and follows changes cheaply: a mod nobody refers to is appended
+    // to it, a mod nobody refers to is erased from it, anything else makes the next "order" call rerun
+    // Kahn's algorithm over ids. The order can be saved along with "fingerprint" of the mod set, and
+    // loading it back for the same set skips resolution entirely.
+    class DependencyGraph {
+    public:
+        using id_type = u32;
+
+        static constexpr u32 format_version = 1;
+
+
+        // Constructor
+
+        DependencyGraph() = default;
+
+
+        // Capacity
+
+        [[nodiscard]]
+        size_t size() const noexcept { return m_present; }
+
+        void reserve(size_t n);
+
+
+        // Modifiers
+
+        // Throws "dependency_error" if a mod with the same name is already added.
+        void add(const Mod& mod);
+        bool remove(std::string_view name);
+
+
+        // Lookup
+
+        [[nodiscard]]
+        bool contains(std::string_view name) const;
+
+        [[nodiscard]]
+        std::string_view name_of(id_type id) const { return m_nodes[id].name; }
+
+
+        // Order
+
+        // Throws "dependency_error" on missing required and loaded incompatible dependencies and on cycles.
+        const std::vector<id_type>& order(std::string_view initial_mod);
+
+        std::vector<std::string> order_names(std::string_view initial_mod);
+
+        // Splits the order into levels: a mod's level is one past the deepest of its dependencies.
+        // The initial mod is alone on the first level, as everything else may build on it implicitly.
+        std::vector<std::vector<id_type>> levels(std::string_view initial_mod);
+
+        // Order-independent hash of added mods, their versions and dependencies.
+        [[nodiscard]]
+        u64 fingerprint() const noexcept { return m_fingerprint; }
+
+        // Saves the last resolved order, does nothing if there's none.
+        void save_order(const fs::path& path) const;
+
+        // Adopts the saved order if it was resolved for the same mods and initial mod.
+        bool load_order(const fs::path& path, std::string_view initial_mod);
+
+
+    private:
+        struct edge_t {
+            id_type id;
+            DependencyType type;
+        };
+
+        struct node_t {
+            std::string name;
+            bool present = false;
+            u64 hash = 0;
+
+            // Declared by this mod.
+            std::vector<edge_t> dependencies;
+            // Present mods declaring this one, of any dependency type.
+            std::vector<edge_t> referrers;
+        };
+
+
+        id_type _intern(std::string_view name);
+
+        bool _has_present_referrers(const node_t& node) const;
+        void _validate(std::string_view initial_mod) const;
+        void _sort(std::string_view initial_mod);
+
+
+        ers::StringMap<id_type> m_ids;
+        std::vector<node_t> m_nodes;
+        size_t m_present = 0;
+        u64 m_fingerprint = 0;
+
+        std::vector<id_type> m_order;
+        std::string m_order_initial;
+        bool m_order_valid = false;
+    };
+}
+
+
+namespace aengine::impl {
+    // A non-empty "order_cache" is tried first, the order is resolved and written there again if it's
+    // missing or was saved for another set of mods.
+    std::vector<std::string> resolve_mods_order(
+        const ModContainer& mods,
+        std::string_view initial_mod,
+        const fs::path& order_cache = {}
+    );
+
+    // Sorts stages by phase, then by mod, then by index, as they're ranked in "mods_order" and "phases_order".
+    // Stages of mods or phases missing there are dropped, repeated ones are kept once.
+    std::vector<stage_order_info_t> order_stages(
+        std::span<const stage_ref_t> stages,
+        std::span<const std::string> mods_order,
+        std::span<const std::string> phases_order
+    );
+
+    // Every stage of "mods" put through "order_stages".
     std::vector<stage_order_info_t> resolve_stages_order(
         const ModContainer& mods,
         std::span<const std::string> mods_order,
         std::span<const std::string> phases_order
     );
+
+    // Same stages as "resolve_stages_order", grouped by phase and then by level of "graph".
+    std::vector<stage_group_t> resolve_stage_groups(
+        const ModContainer& mods,
+        DependencyGraph& graph,
+        std::string_view initial_mod,
+        std::span<const std::string> phases_order
+    );
 }
 
 
@@ -31,6 +183,12 @@ namespace aengine::impl {
 
 namespace aengine {
     using impl::stage_order_info_t;
+    using impl::stage_ref_t;
+    using impl::mod_stages_t;
+    using impl::stage_group_t;
+    using impl::DependencyGraph;
     using impl::resolve_mods_order;
+    using impl::order_stages;
     using impl::resolve_stages_order;
+    using impl::resolve_stage_groups;
 }
@@ -0,0 +1,122 @@
+#pragma once
+
+// std
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// sol
+#include <sol/state.hpp>
+
+// ers
+#include <erslib/core/memory/function.hpp>
+
+
+// Warm Lua states for mod runtimes.
+//
+// A state is created once, has its libraries opened by "init" and its sandbox built. When a lease
+// is over, the sandbox is restored and garbage is collected instead of closing the state, so the next
+// "acquire" skips all of that. Runtimes initialized on a leased state must be dropped before the lease.
+
+namespace aengine::impl {
+    class LuaStatePool {
+    public:
+        using init_fn = ers::function<void(sol::state&)>;
+
+
+        class Lease {
+        public:
+            // Constructor
+
+            Lease() = default;
+
+            Lease(Lease&& other) noexcept = default;
+            Lease& operator=(Lease&& other) noexcept;
+
+
+            // Destructor
+
+            ~Lease();
+
+
+            // Observers
+
+            [[nodiscard]]
+            explicit operator bool() const noexcept { return m_state != nullptr; }
+
+
+            // Accessors
+
+            sol::state& operator*() const noexcept { return *m_state; }
+            sol::state* operator->() const noexcept { return m_state.get(); }
+
+
+        private:
+            friend class LuaStatePool;
+
+            Lease(LuaStatePool* pool, std::unique_ptr<sol::state> state) :
+                m_pool(pool), m_state(std::move(state)) {
+            }
+
+
+            LuaStatePool* m_pool = nullptr;
+            std::unique_ptr<sol::state> m_state;
+        };
+
+
+        // Constructor
+
+        // Keeps at most "capacity" idle states, extra ones are closed on return.
+        explicit LuaStatePool(size_t capacity, init_fn init = &default_init);
+
+        LuaStatePool(const LuaStatePool&) = delete;
+        LuaStatePool& operator=(const LuaStatePool&) = delete;
+
+
+        // Modifiers
+
+        [[nodiscard]]
+        Lease acquire();
+
+        // Creates idle states up to "count" ahead of time.
+        void warm_up(size_t count);
+
+        void clear();
+
+
+        // Observers
+
+        [[nodiscard]]
+        size_t idle() const;
+
+        [[nodiscard]]
+        size_t capacity() const noexcept { return m_capacity; }
+
+
+        // Details
+
+        // Opens base, coroutine, math, string and table libraries.
+        static void default_init(sol::state& lua);
+
+
+    private:
+        [[nodiscard]]
+        std::unique_ptr<sol::state> _create() const;
+
+        void _release(std::unique_ptr<sol::state> state) noexcept;
+
+
+        size_t m_capacity;
+        init_fn m_init;
+
+        mutable std::mutex m_mutex;
+        std::vector<std::unique_ptr<sol::state>> m_idle;
+    };
+}
+
+
+// Exports
+
+namespace aengine {
+    using impl::LuaStatePool;
+}
@@ -1,23 +1,74 @@
 #pragma once
 
+// std
+#include <algorithm>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <ranges>
+#include <stop_token>
+#include <string>
+#include <utility>
+#include <vector>
+
 // ers
 #include <erslib/core/hashing/rapid.hpp>
-#include <erslib/core/thread_safe/map.hpp>
+#include <erslib/core/fwd.hpp>
+#include <erslib/core/thread_safe.hpp>
 #include <erslib/core/type/diagnostic.hpp>
 #include <erslib/core/type/result.hpp>
 #include <erslib/aengine/resource.hpp>
+#include <erslib/aengine/resource_cache.hpp>
 #include <erslib/aengine/fwd.hpp>
 
 
 namespace aengine::impl {
+    // Result of "ResourceManager::get_async", the load may still be queued or running.
+    template<typename T>
+    class PendingHandle {
+        friend class ResourceManager;
+
+
+    public:
+        // Observers
+
+        [[nodiscard]]
+        bool valid() const noexcept { return m_future.valid(); }
+
+        [[nodiscard]]
+        bool ready() const {
+            return m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }
+
+
+        // Modifiers
+
+        // Blocks until the load is over, may be called once.
+        ers::Result<Handle<T>> get() { return m_future.get(); }
+
+        void wait() const { m_future.wait(); }
+
+        // A load that hasn't started yet is skipped and finishes with an error, a running one isn't interrupted.
+        void cancel() noexcept { m_stop.request_stop(); }
+
+
+    private:
+        PendingHandle(std::future<ers::Result<Handle<T>>> future, std::stop_source stop) :
+            m_future(std::move(future)),
+            m_stop(std::move(stop)) {
+        }
+
+
+        std::future<ers::Result<Handle<T>>> m_future;
+        std::stop_source m_stop;
+    };
+
+
     class ResourceManager {
-        using underlying_container_type = ers::HashMap<
-            std::string, Object,
-            ers::string_hash_adaptor<ers::RapidHash>,
-            ers::equal_adaptor<std::string>
-        >;
+        using underlying_container_type = ers::StringMap<Object>;
 
-        using container_type = ers::thread_safe::Map<underlying_container_type>;
+        // Resources are looked up from many worker threads, so the map is striped to keep them off one mutex.
+        using container_type = ers::thread_safe::ShardedMap<underlying_container_type>;
 
 
     public:
@@ -27,7 +78,21 @@ namespace aengine::impl {
 
         // Constructor
 
-        ResourceManager() = default;
+        static constexpr size_t default_cache_budget = 256 * 1024 * 1024;
+
+
+        // "loaders" is amount of threads doing background loads, "cache_budget" is amount of bytes
+        // unused resources may keep loaded (0 unloads them right away).
+        explicit ResourceManager(size_t loaders = default_loaders(), size_t cache_budget = default_cache_budget) :
+            m_cache(cache_budget),
+            m_loaders(loaders) {
+        }
+
+
+        [[nodiscard]]
+        static size_t default_loaders() noexcept {
+            return std::max<size_t>(ers::thread_safe::WorkerPool::default_threads() / 2, 1);
+        }
 
 
         // Capacity
@@ -46,22 +111,118 @@ namespace aengine::impl {
             return m_data.set(k, Object::make<resource_type_t<T>>(std::forward<Args>(args)...));
         }
 
+        // Preloads resources of one type, "items" is a range of pairs of a key and the resource's constructor argument.
+        // Locks every shard once per call, returns amount of inserted resources.
+        template<typename T, std::ranges::input_range R>
+        size_t set_many(R&& items) {
+            std::vector<std::pair<std::string, Object>> objects;
+
+            if constexpr (std::ranges::sized_range<R>)
+                objects.reserve(std::ranges::size(items));
+
+            for (auto&& [k, arg] : items)
+                objects.emplace_back(std::string(k), Object::make<resource_type_t<T>>(arg));
+
+            return m_data.set_many(std::move(objects));
+        }
+
 
         template<typename T, typename K>
         ers::Result<Handle<T>> get(const K& k) const {
-            auto result = m_data.get(k);
+            using resource_type = resource_type_t<T>;
 
+            // Only the control block is taken under the shard lock, a load may take long and would stall
+            // writers of the whole shard. Entries are never erased, so the block outlives the lock.
+            auto result = m_data.pin(k);
 
             if (!result)
                 return ers::make_error("Element with key {} is not found", k);
 
+            auto& cb = result->template get<resource_type>().control_block();
+            result.reset();
 
-            return result->template get<resource_type_t<T>>().view();
+
+            auto handle = resource_type::view(cb);
+
+            if (handle)
+                m_cache.retain<T>(k, *handle);
+
+            return handle;
+        }
+
+        // Same as "get", but the lookup and the load run on a loader thread.
+        template<typename T, typename K>
+        PendingHandle<T> get_async(const K& k, ers::thread_safe::TaskPriority priority = ers::thread_safe::TaskPriority::Normal) {
+            std::promise<ers::Result<Handle<T>>> promise;
+            auto future = promise.get_future();
+
+            auto stop = m_loaders.post(
+                [this, key = std::string(k), promise = std::move(promise)](std::stop_token token) mutable {
+                    if (token.stop_requested()) {
+                        promise.set_value(ers::make_error("Loading of {} is cancelled", key));
+                        return;
+                    }
+
+                    try {
+                        promise.set_value(get<T>(key));
+                    } catch (...) {
+                        promise.set_exception(std::current_exception());
+                    }
+                },
+                priority
+            );
+
+            return PendingHandle<T>(std::move(future), std::move(stop));
+        }
+
+        // Loads the resource in background and keeps it loaded until "release_prefetched".
+        // Returns the source that cancels the load, failed loads are just not kept.
+        template<typename T, typename K>
+        std::stop_source prefetch(const K& k, ers::thread_safe::TaskPriority priority = ers::thread_safe::TaskPriority::Low) {
+            return m_loaders.post(
+                [this, key = std::string(k)](std::stop_token token) {
+                    if (token.stop_requested())
+                        return;
+
+                    try {
+                        if (auto handle = get<T>(key))
+                            m_prefetched.set(key, std::make_shared<const Handle<T>>(std::move(handle).value()));
+                    } catch (...) {
+                        // Prefetch is a hint, the error shows up again on the real "get".
+                    }
+                },
+                priority
+            );
+        }
+
+        void release_prefetched(std::string_view k) {
+            m_prefetched.erase(k);
+        }
+
+        void release_prefetched() {
+            m_prefetched.clear();
+        }
+
+        // Unused resources kept loaded, see "ResourceCache".
+        [[nodiscard]]
+        ResourceCache& cache() const noexcept { return m_cache; }
+
+        // Blocks until every queued load is done.
+        void wait_loads() {
+            m_loaders.wait_idle();
         }
 
 
     protected:
         container_type m_data;
+
+        mutable ResourceCache m_cache;
+
+        // Type-erased handles keeping prefetched resources loaded.
+        ers::thread_safe::ShardedMap<ers::StringMap<std::shared_ptr<const void>>> m_prefetched;
+
+        // Last, so loaders are joined before the maps they use are destroyed.
+        ers::thread_safe::WorkerPool m_loaders;
     };
 }
 
@@ -69,5 +230,6 @@ namespace aengine::impl {
 // Exports
 
 namespace aengine {
+    using impl::PendingHandle;
     using impl::ResourceManager;
 }
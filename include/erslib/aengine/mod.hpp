@@ -3,7 +3,10 @@
 // std
 #include <exception>
 #include <filesystem>
+#include <memory>
+#include <span>
 #include <string>
+#include <vector>
 
 // boost
 #include <boost/unordered/unordered_set.hpp>
@@ -15,12 +18,22 @@
 // ers
 #include <erslib/aengine/dependency.hpp>
 #include <erslib/aengine/fwd.hpp>
+#include <erslib/aengine/util/stage.hpp>
+#include <erslib/core/memory/function.hpp>
 #include <erslib/core/type/version.hpp>
 
 
 namespace fs = std::filesystem;
 
 
+// Forward declaration
+
+namespace aengine::impl {
+    class BytecodeCache;
+    class ModArchive;
+}
+
+
 // Internal
 
 namespace aengine::impl {
@@ -42,14 +55,22 @@ namespace aengine::impl {
     struct ModContent {
         ers::StringMap<std::string> packages;
         ers::StringMap<std::string> stages;
+
+        // Names of "stages" parsed once, stages not following '<phase>-<index>' are absent.
+        ers::StringMap<util::stage_info_t> stage_infos;
     };
 
 
     struct ModRuntime {
         ers::StringMap<sol::object> modules_cache;
+        // Package -> packages and stages that required it, recorded as they run.
+        ers::StringMap<std::vector<std::string>> dependents;
+        // Stage and packages being executed, innermost last.
+        std::vector<std::string> loading;
         sol::protected_function main;
         sol::environment env;
         std::exception_ptr pending_exception = nullptr;
+        BytecodeCache* bytecode_cache = nullptr;
     };
 }
 
@@ -69,6 +90,7 @@ namespace aengine::impl {
 
         // Constructor
 
+        // "dir" is either the mod directory or its "ModArchive".
         explicit Mod(fs::path dir);
 
 
@@ -79,15 +101,28 @@ namespace aengine::impl {
         void drop_metadata() const { m_metadata.reset(); }
 
         void init_content(const std::function<bool(std::string_view)>& stage_filter) const;
+        // Rereads changed, added or removed sources and drops modules built from them out of the runtime.
+        // Returns names of stages to run again: changed ones and ones that required a changed package.
+        std::vector<std::string> reload_files(
+            std::span<const fs::path> files,
+            const std::function<bool(std::string_view)>& stage_filter
+        ) const;
         void drop_content() const { m_content.reset(); }
 
-        void init_runtime(sol::state_view& lua) const;
+        // Chunks are compiled through "bytecode_cache" when it's given, it must outlive the runtime.
+        void init_runtime(sol::state_view& lua, BytecodeCache* bytecode_cache = nullptr) const;
+        // Empties the environment and the modules cache, keeps the Lua state and the environment table.
+        void reset_runtime() const;
         void load_runtime(std::string_view stage_name) const;
         void drop_runtime() const { m_runtime.reset(); }
 
 
         // Accessors
 
+        const fs::path& dir() const { return m_dir; }
+        // Set by "init_info" for packed mods.
+        const ModArchive* archive() const { return m_archive.get(); }
+
         std::string_view name() const { return m_identity.name; }
         std::string_view title() const { return m_identity.title; }
         const ers::version_t& version() const { return m_identity.version; }
@@ -101,6 +136,7 @@ namespace aengine::impl {
 
     protected:
         fs::path m_dir;
+        std::shared_ptr<const ModArchive> m_archive;
         identity_type m_identity;
         mutable std::unique_ptr<metadata_type> m_metadata;
         mutable std::unique_ptr<content_type> m_content;
@@ -108,7 +144,10 @@ namespace aengine::impl {
 
 
     private:
-        std::function<sol::object(sol::this_state, std::string_view)> _make_require_fn() const;
+        void _fill_env() const;
+        ers::function<sol::object(sol::this_state, std::string_view)> _make_require_fn() const;
+
+        sol::load_result _load_chunk(sol::state_view& lua, std::string_view name, std::string_view source) const;
     };
 
 
@@ -0,0 +1,120 @@
+#pragma once
+
+// std
+#include <filesystem>
+#include <string_view>
+
+// ers
+#include <erslib/core/memory/mapped_file.hpp>
+#include <erslib/core/type/general.hpp>
+#include <erslib/core/type/optional.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+// Mod packed into a single file.
+//
+// Layout: header, contents of every file back to back, index of entries sorted by path, then the paths.
+// The index holds offset, size and RapidHash of every file. The archive is mapped as a whole and
+// checked once when it's opened, files are served as views into the mapping without further I/O.
+// Integers are stored in the byte order of the packing machine.
+
+namespace aengine::impl {
+    enum class ArchiveCompression : u32 {
+        None = 0
+    };
+
+
+    class ModArchive {
+    public:
+        static constexpr u32 format_version = 1;
+        static constexpr std::string_view extension = ".aemod";
+
+
+        struct file_t {
+            // Relative to the mod directory, separated by '/'.
+            std::string_view path;
+            std::string_view data;
+            u64 hash;
+        };
+
+
+        // Constructor
+
+        explicit ModArchive(const fs::path& path);
+
+
+        // Accessors
+
+        [[nodiscard]]
+        file_t at(size_t index) const;
+
+        [[nodiscard]]
+        ers::optional<file_t> find(std::string_view path) const;
+
+
+        // Observers
+
+        [[nodiscard]]
+        size_t size() const noexcept { return m_count; }
+
+        [[nodiscard]]
+        const fs::path& path() const noexcept { return m_path; }
+
+        // Rehashes every file, true if all of them match the index.
+        [[nodiscard]]
+        bool verify() const;
+
+
+    private:
+        friend void pack_mod_archive(const fs::path& dir, const fs::path& archive);
+
+
+        struct header_t {
+            char magic[4];
+            u32 format;
+            u64 count;
+            u64 index_offset;
+            u64 paths_offset;
+            u64 paths_size;
+        };
+
+        struct entry_t {
+            u64 path_offset;
+            u32 path_size;
+            ArchiveCompression compression;
+            u64 offset;
+            u64 size;
+            u64 hash;
+        };
+
+
+        // Index isn't aligned in the mapping, entries are copied out.
+        [[nodiscard]]
+        entry_t _entry(size_t index) const;
+
+        [[nodiscard]]
+        file_t _file(const entry_t& entry) const;
+
+
+        fs::path m_path;
+        ers::MappedFile m_file;
+        size_t m_count = 0;
+        const char* m_index = nullptr;
+        const char* m_paths = nullptr;
+    };
+
+
+    // Packs every regular file under "dir". The archive is written aside and renamed over "archive".
+    void pack_mod_archive(const fs::path& dir, const fs::path& archive);
+}
+
+
+// Exports
+
+namespace aengine {
+    using impl::ArchiveCompression;
+    using impl::ModArchive;
+    using impl::pack_mod_archive;
+}
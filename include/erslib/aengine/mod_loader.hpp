@@ -0,0 +1,59 @@
+#pragma once
+
+// std
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ers
+#include <erslib/aengine/mod.hpp>
+#include <erslib/core/thread_safe.hpp>
+
+
+// Startup loading of installed mods.
+//
+// Every mod is a task on the pool: its "info.json" is parsed and its sources are read there, so file I/O
+// of different mods overlaps. Results are gathered only after every task is over, the first failure
+// (in discovery order: roots as given, mods of a root by their paths) is rethrown then.
+
+namespace aengine::impl {
+    struct loaded_mods_t {
+        ModContainer mods;
+        std::vector<std::string> order;
+    };
+
+
+    // Every subdirectory and ".aemod" archive of every root is a mod. "stage_filter" is called concurrently.
+    ModContainer discover_mods(
+        std::span<const fs::path> roots,
+        const std::function<bool(std::string_view)>& stage_filter,
+        ers::thread_safe::WorkerPool& pool
+    );
+
+    ModContainer discover_mods(
+        std::span<const fs::path> roots,
+        const std::function<bool(std::string_view)>& stage_filter
+    );
+
+
+    // "discover_mods" followed by "resolve_mods_order", "order_cache" is passed to the latter.
+    loaded_mods_t load_mods(
+        std::span<const fs::path> roots,
+        std::string_view initial_mod,
+        const std::function<bool(std::string_view)>& stage_filter,
+        ers::thread_safe::WorkerPool& pool,
+        const fs::path& order_cache = {}
+    );
+}
+
+
+// Exports
+
+namespace aengine {
+    using impl::loaded_mods_t;
+    using impl::discover_mods;
+    using impl::load_mods;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ers
+#include <erslib/aengine/dependency_graph.hpp>
+#include <erslib/aengine/mod.hpp>
+#include <erslib/core/fwd.hpp>
+
+
+// Hot reload of mods during development.
+//
+// "ModWatcher" reports sources and "info.json" files edited under mod directories: through inotify
+// on Linux, by comparing modification times elsewhere. "apply_mod_changes" feeds the reported files
+// to "Mod::reload_files" and returns only the stages that have to run again.
+
+namespace aengine::impl {
+    struct mod_change_t {
+        std::string mod;
+        // Changed, added or removed sources.
+        std::vector<fs::path> files;
+        // "info.json" changed or a directory was removed, the mod has to be loaded again as a whole.
+        bool reinit = false;
+    };
+
+
+    class ModWatcher {
+    public:
+        // Constructor
+
+        explicit ModWatcher(const ModContainer& mods);
+
+        ModWatcher(const ModWatcher&) = delete;
+        ModWatcher& operator=(const ModWatcher&) = delete;
+
+
+        // Destructor
+
+        ~ModWatcher();
+
+
+        // Modifiers
+
+        void watch(const Mod& mod);
+
+        // Waits up to "timeout" for the first change, returns everything reported by then merged per mod.
+        std::vector<mod_change_t> poll(std::chrono::milliseconds timeout = std::chrono::milliseconds(0));
+
+
+    private:
+        struct watch_t {
+            std::string mod;
+            fs::path root;
+            fs::path dir;
+        };
+
+
+        bool _watch_dir(const std::string& mod, const fs::path& root, const fs::path& dir);
+        std::vector<mod_change_t> _collect();
+
+
+#ifdef __linux__
+        int m_fd = -1;
+        // inotify watch descriptor -> directory
+        ers::TrivialMap<watch_t> m_watches;
+#else
+        struct stamp_t {
+            fs::file_time_type time;
+            size_t watch;
+        };
+
+        std::vector<watch_t> m_watches;
+        // file -> last seen modification time
+        ers::StringMap<stamp_t> m_stamps;
+#endif
+    };
+
+
+    struct reload_plan_t {
+        // Mods reported with "reinit", nothing of them is reloaded here.
+        std::vector<std::string> reinit;
+        // Stages to run again, ordered as by "resolve_stages_order".
+        std::vector<stage_order_info_t> stages;
+    };
+
+    reload_plan_t apply_mod_changes(
+        const ModContainer& mods,
+        std::span<const mod_change_t> changes,
+        const std::function<bool(std::string_view)>& stage_filter,
+        std::span<const std::string> mods_order,
+        std::span<const std::string> phases_order
+    );
+}
+
+
+// Exports
+
+namespace aengine {
+    using impl::mod_change_t;
+    using impl::ModWatcher;
+    using impl::reload_plan_t;
+    using impl::apply_mod_changes;
+}
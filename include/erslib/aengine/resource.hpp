@@ -2,12 +2,12 @@
 
 // std
 #include <atomic>
-#include <functional>
-#include <mutex>
+#include <utility>
 
 // ers
-#include <erslib/core/memory/holder.hpp>
+#include <erslib/core/memory.hpp>
 #include <erslib/core/meta/type_hash.hpp>
+#include <erslib/core/type/general.hpp>
 #include <erslib/core/type/result.hpp>
 #include <erslib/core/type/optional.hpp>
 
@@ -23,10 +23,25 @@ namespace aengine::impl {
 // Control block
 
 namespace aengine::impl {
+    enum class ResourceState : u32 {
+        Empty = 0,
+        Loading,
+        Ready,
+        Unloading
+    };
+
+
+    // Loads the value on the first reference and unloads it after the last one is gone.
+    //
+    // The state only moves empty -> loading -> ready -> unloading -> empty, every transition is
+    // done by a single thread that won the CAS on "state", others park on "state.wait" until it's over.
+    // "refs" is raised before "state" is looked at, and the unloader looks at "refs" after it has taken
+    // "state", both sides are seq_cst, so a reader either sees "Unloading" and waits or the unloader
+    // sees the new reference and puts the value back.
     template<typename T>
     struct control_block_t {
-        using ctor_fn = std::function<ers::Status(control_block_t& cb)>;
-        using dtor_fn = std::function<void(control_block_t& cb)>;
+        using ctor_fn = ers::function<ers::Status(control_block_t& cb)>;
+        using dtor_fn = ers::function<void(control_block_t& cb)>;
 
 
         control_block_t(ctor_fn ctor, dtor_fn dtor) :
@@ -35,15 +50,92 @@ namespace aengine::impl {
         }
 
 
+        // Takes a reference and makes sure the value is loaded, the reference is dropped on failure
+        // or when the loader throws.
+        ers::Status acquire() {
+            refs.fetch_add(1, std::memory_order_seq_cst);
+
+            while (true) {
+                auto current = state.load(std::memory_order_seq_cst);
+
+                if (current == ResourceState::Ready)
+                    return ers::ok;
+
+                if (current != ResourceState::Empty) {
+                    state.wait(current, std::memory_order_acquire);
+                    continue;
+                }
+
+                if (!state.compare_exchange_strong(current, ResourceState::Loading, std::memory_order_seq_cst))
+                    continue;
+
+
+                ers::Status status = ers::ok;
+
+                try {
+                    status = ctor(*this);
+                } catch (...) {
+                    // Same as a failed load, otherwise waiters would park on "Loading" forever.
+                    _publish(ResourceState::Empty);
+                    refs.fetch_sub(1, std::memory_order_release);
+                    throw;
+                }
+
+                _publish(status ? ResourceState::Ready : ResourceState::Empty);
+
+                if (!status) {
+                    // Nobody can hold the value yet, so there is nothing to unload.
+                    refs.fetch_sub(1, std::memory_order_release);
+                    return status;
+                }
+
+                return ers::ok;
+            }
+        }
+
+        // Takes one more reference on an already acquired value.
+        void share() noexcept {
+            refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        void release() {
+            if (refs.fetch_sub(1, std::memory_order_seq_cst) != 1)
+                return;
+
+            // Last reference is gone, but a reader may come back at any moment.
+            while (refs.load(std::memory_order_seq_cst) == 0) {
+                auto expected = ResourceState::Ready;
+
+                if (!state.compare_exchange_strong(expected, ResourceState::Unloading, std::memory_order_seq_cst))
+                    return;
+
+                if (refs.load(std::memory_order_seq_cst) == 0) {
+                    dtor(*this);
+                    _publish(ResourceState::Empty);
+                    return;
+                }
+
+                _publish(ResourceState::Ready);
+            }
+        }
+
+
         ers::optional<T> value = ers::nullopt;
         std::atomic<size_t> refs = 0;
-        std::mutex mutex;
+        std::atomic<ResourceState> state = ResourceState::Empty;
         ctor_fn ctor;
         dtor_fn dtor;
+
+
+    private:
+        void _publish(ResourceState next) noexcept {
+            state.store(next, std::memory_order_seq_cst);
+            state.notify_all();
+        }
     };
 
     template<typename T>
-    using control_block_ptr = ers::Holder<control_block_t<T>>;
+    using control_block_ptr = ers::holder_ptr<control_block_t<T>>;
 }
 
 
@@ -63,22 +155,20 @@ namespace aengine::impl {
 
         Handle(const Handle& other) :
             m_cb(other.m_cb) {
-            _acquire();
+            if (m_cb)
+                m_cb->share();
         }
         Handle& operator=(const Handle& other) {
-            m_cb = other.m_cb;
-            _acquire();
+            Handle(other).swap(*this);
             return *this;
         }
 
 
         Handle(Handle&& other) noexcept :
-            m_cb(other.m_cb) {
-            other.m_cb = nullptr;
+            m_cb(std::exchange(other.m_cb, nullptr)) {
         }
         Handle& operator=(Handle&& other) noexcept {
-            m_cb = other.m_cb;
-            other.m_cb = nullptr;
+            Handle(std::move(other)).swap(*this);
             return *this;
         }
 
@@ -86,10 +176,30 @@ namespace aengine::impl {
         // Destructor
 
         ~Handle() {
-            _release();
+            if (m_cb)
+                m_cb->release();
+        }
+
+
+        // Modifiers
+
+        void swap(Handle& other) noexcept {
+            std::swap(m_cb, other.m_cb);
         }
 
 
+        // Observers
+
+        // Amount of handles sharing the resource, this one included.
+        [[nodiscard]]
+        size_t use_count() const noexcept {
+            return m_cb ? m_cb->refs.load(std::memory_order_relaxed) : 0;
+        }
+
+        [[nodiscard]]
+        explicit operator bool() const noexcept { return m_cb != nullptr; }
+
+
         // Accessors
 
         const T* get() const { return m_cb->value.get(); }
@@ -103,19 +213,9 @@ namespace aengine::impl {
 
 
     private:
+        // Adopts a reference already taken by "control_block_t::acquire".
         explicit Handle(control_block_t<T>& cb) :
             m_cb(&cb) {
-            _acquire();
-        }
-
-
-        void _acquire() {
-            m_cb->refs.fetch_add(1, std::memory_order_release);
-        }
-
-        void _release() {
-            if (m_cb && m_cb->refs.fetch_sub(1, std::memory_order_release) == 1)
-                m_cb->dtor(*m_cb);
         }
     };
 }
@@ -124,9 +224,9 @@ namespace aengine::impl {
 // Control block helper functions
 
 namespace aengine::impl {
+    // Runs while the block is "Unloading", so no one else touches the value.
     template<typename T>
     void default_dtor(control_block_t<T>& cb) {
-        std::scoped_lock lock(cb.mutex);
         cb.value.reset();
     }
 }
@@ -151,15 +251,31 @@ namespace aengine::impl {
 
         // Observers
 
+        // Loads the resource if nobody holds it, concurrent callers wait for the same load.
         [[nodiscard]]
         ers::Result<Handle<T>> view() const {
-            if (!m_cb->refs.load(std::memory_order_acquire)) {
-                if (auto s = m_cb->ctor(*m_cb); !s)
-                    return s.error();
-            }
+            return view(*m_cb);
+        }
+
+        // Same as above, but on a block taken out of the resource with "control_block".
+        [[nodiscard]]
+        static ers::Result<Handle<T>> view(control_block_type& cb) {
+            if (auto s = cb.acquire(); !s)
+                return s.error();
 
+            return Handle<T>(cb);
+        }
 
-            return Handle<T>(*m_cb);
+        [[nodiscard]]
+        ResourceState state() const {
+            return m_cb->state.load(std::memory_order_acquire);
+        }
+
+
+        // The block is allocated once and doesn't move with the resource, so it stays valid while the resource lives.
+        [[nodiscard]]
+        control_block_type& control_block() const noexcept {
+            return *m_cb;
         }
 
 
@@ -170,7 +286,7 @@ namespace aengine::impl {
 
 
     protected:
-        ers::Holder<control_block_type> m_cb;
+        ers::holder_ptr<control_block_type> m_cb;
     };
 }
 
@@ -178,6 +294,7 @@ namespace aengine::impl {
 // Exports
 
 namespace aengine {
+    using impl::ResourceState;
     using impl::Handle;
     using impl::TResource;
 }
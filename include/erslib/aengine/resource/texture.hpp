@@ -5,6 +5,7 @@
 
 // aengine
 //#include <erslib/aengine/resource.hpp>
+//#include <erslib/aengine/resource_cache.hpp>
 
 
 // TextureResource
@@ -31,3 +32,17 @@
 //        using type = TextureResource;
 //    };
 //}
+
+
+// Size estimation
+
+//namespace aengine {
+//    // Pixels live in video memory, but they are what the cache should account for, RGBA is 4 bytes per pixel.
+//    template<>
+//    struct resource_size<sf::Texture> {
+//        size_t operator()(const sf::Texture& texture) const noexcept {
+//            const auto size = texture.getSize();
+//            return static_cast<size_t>(size.x) * size.y * 4;
+//        }
+//    };
+//}
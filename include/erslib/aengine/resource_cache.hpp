@@ -0,0 +1,131 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ers
+#include <erslib/core/fwd.hpp>
+#include <erslib/aengine/resource.hpp>
+
+
+// Size estimation
+
+namespace aengine {
+    // Bytes a loaded resource is charged against the cache budget. Specialize it for types owning
+    // memory outside of themselves (textures, sounds, meshes).
+    template<typename T>
+    struct resource_size {
+        size_t operator()(const T&) const noexcept {
+            return sizeof(T);
+        }
+    };
+}
+
+
+// ResourceCache
+
+namespace aengine::impl {
+    // Keeps recently used resources loaded after their last outside handle is gone.
+    //
+    // Every cached resource holds one handle here, so "use_count() == 1" means nobody else uses it.
+    // Those are reclaimed with CLOCK once the budget is exceeded: a hit only sets the entry's referenced
+    // bit under a shared lock, the hand clears the bits and evicts entries that weren't hit since
+    // its last pass. Resources in use are never evicted, even if that keeps the cache over budget.
+    class ResourceCache {
+    public:
+        // Constructor
+
+        explicit ResourceCache(size_t budget) :
+            m_budget(budget) {
+        }
+
+
+        // Capacity
+
+        [[nodiscard]]
+        size_t budget() const noexcept { return m_budget.load(std::memory_order_relaxed); }
+
+        [[nodiscard]]
+        size_t usage() const;
+
+        [[nodiscard]]
+        size_t size() const;
+
+
+        // Modifiers
+
+        // Marks the resource as used, caches it on the first call.
+        template<typename T>
+        void retain(std::string_view key, const Handle<T>& handle) {
+            if (!handle || !budget())
+                return;
+
+            {
+                std::shared_lock lock(m_mutex);
+
+                if (auto it = m_index.find(key); it != m_index.end()) {
+                    m_entries[it->second]->referenced.store(true, std::memory_order_relaxed);
+                    return;
+                }
+            }
+
+            const size_t bytes = resource_size<T> {}(*handle);
+            _insert(key, std::make_shared<const Handle<T>>(handle), &use_count_of<T>, bytes);
+        }
+
+        // Evicts unused resources until the usage fits "budget", returns amount of freed bytes.
+        size_t trim(size_t budget);
+        size_t trim() { return trim(budget()); }
+
+        void set_budget(size_t budget);
+
+        void erase(std::string_view key);
+        void clear();
+
+
+    private:
+        using use_count_fn = size_t (*)(const void* handle);
+
+        struct entry_t {
+            std::string key;
+            std::shared_ptr<const void> handle;
+            use_count_fn use_count;
+            size_t bytes;
+            std::atomic<bool> referenced = true;
+        };
+
+
+        template<typename T>
+        static size_t use_count_of(const void* handle) {
+            return static_cast<const Handle<T>*>(handle)->use_count();
+        }
+
+
+        void _insert(std::string_view key, std::shared_ptr<const void> handle, use_count_fn use_count, size_t bytes);
+
+        // mutex should be acquired already, evicted handles are moved to "out" to be released unlocked
+        size_t _trim(size_t budget, std::vector<std::shared_ptr<const void>>& out);
+        // mutex should be acquired already
+        std::shared_ptr<const void> _remove(size_t index);
+
+
+        mutable std::shared_mutex m_mutex;
+        std::vector<std::unique_ptr<entry_t>> m_entries;
+        ers::StringMap<size_t> m_index;
+        size_t m_hand = 0;
+        size_t m_usage = 0;
+        std::atomic<size_t> m_budget;
+    };
+}
+
+
+// Exports
+
+namespace aengine {
+    using impl::ResourceCache;
+}
@@ -2,12 +2,14 @@
 
 // std
 #include <string>
+#include <string_view>
 #include <variant>
 
 // ers
 #include <erslib/aengine/fwd.hpp>
 #include <erslib/core/type/general.hpp>
 #include <erslib/core/type/none.hpp>
+#include <erslib/core/type/optional.hpp>
 
 
 namespace aengine::impl {
@@ -51,10 +53,6 @@ namespace aengine::impl {
         using Type = T;
         using ViewType = ViewT;
 
-        // Modifiers
-
-        void set(ViewT value) { m_value = value; }
-
 
         // Accessors
 
@@ -76,39 +74,116 @@ namespace aengine::impl {
             m_default_value(default_value) {
             m_value = m_default_value;
         }
+
+        // Checks are up to derived settings.
+        void _assign(ViewT value) { m_value = T(value); }
     };
 }
 
 
+// Every "set" checks the value first and leaves the setting as is if it's rejected.
+// Constructors throw if the default value doesn't pass the checks itself.
+
 namespace aengine::impl {
-    class BoolSetting : BaseSetting<bool> {
+    class BoolSetting : public BaseSetting<bool> {
     public:
-        BoolSetting(ViewType default_value, ViewType forced_value);
+        // A forced setting keeps "forced_value" regardless of what is set.
+        explicit BoolSetting(ViewType default_value, ers::optional<Type> forced_value = ers::nullopt);
+
+
+        // Modifiers
+
+        bool set(ViewType value);
+        void reset() { m_value = m_forced_value.value_or(m_default_value); }
+
+
+        // Observers
+
+        [[nodiscard]]
+        bool accepts(ViewType value) const { return !m_forced_value || *m_forced_value == value; }
+
+        [[nodiscard]]
+        bool is_forced() const { return m_forced_value.has_value(); }
+
 
     protected:
-        Type m_forced_value;
+        ers::optional<Type> m_forced_value;
     };
 
-    class IntSetting : BaseSetting<i64> {
+    class IntSetting : public BaseSetting<i64> {
     public:
+        explicit IntSetting(ViewType default_value, check_states_t<Type> check_states = ers::none);
+
+
+        // Modifiers
+
+        bool set(ViewType value);
+        void reset() { m_value = m_default_value; }
+
+
+        // Observers
+
+        [[nodiscard]]
+        bool accepts(ViewType value) const;
+
 
     protected:
         check_states_t<Type> m_check_states;
     };
 
-    class DoubleSetting : BaseSetting<f64> {
+    class DoubleSetting : public BaseSetting<f64> {
     public:
+        explicit DoubleSetting(ViewType default_value, check_states_t<Type> check_states = ers::none);
+
+
+        // Modifiers
+
+        bool set(ViewType value);
+        void reset() { m_value = m_default_value; }
+
+
+        // Observers
+
+        // NaN is never accepted.
+        [[nodiscard]]
+        bool accepts(ViewType value) const;
+
 
     protected:
         check_states_t<Type> m_check_states;
     };
 
-    class StringSetting : BaseSetting<std::string, std::string_view> {
+    class StringSetting : public BaseSetting<std::string, std::string_view> {
     public:
+        // Empty "allowed_values" allows any value.
+        explicit StringSetting(
+            ViewType default_value,
+            bool allow_blank = true,
+            bool auto_trim = false,
+            allowed_values_t<Type> allowed_values = {}
+        );
+
+
+        // Modifiers
+
+        // Trimmed before it's checked if "auto_trim" is set.
+        bool set(ViewType value);
+        void reset() { m_value = m_default_value; }
+
+
+        // Observers
+
+        [[nodiscard]]
+        bool accepts(ViewType value) const;
+
 
     protected:
         bool m_allow_blank, m_auto_trim;
         allowed_values_t<Type> m_allowed_values;
+
+
+        [[nodiscard]]
+        ViewType _normalize(ViewType value) const;
     };
 }
 
@@ -0,0 +1,194 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+// ers
+#include <erslib/aengine/setting.hpp>
+#include <erslib/contrib/json.hpp>
+#include <erslib/core/exception.hpp>
+#include <erslib/core/fwd.hpp>
+#include <erslib/core/memory/function.hpp>
+#include <erslib/core/memory/shared_ptr.hpp>
+#include <erslib/core/type/optional.hpp>
+#include <erslib/core/type/result.hpp>
+
+
+// Named settings read from many threads.
+//
+// Writers go through the registry under a mutex: values are checked by their setting, then a new
+// immutable snapshot of all values is published and change callbacks are called outside of the lock,
+// on the writer's thread. Readers never touch the settings themselves: they hold a snapshot and
+// "refresh" it, which is a single atomic load unless something has changed.
+
+namespace aengine::impl {
+    using setting_t = std::variant<BoolSetting, IntSetting, DoubleSetting, StringSetting>;
+    // Alternatives follow "setting_t".
+    using setting_value_t = std::variant<bool, i64, f64, std::string>;
+
+
+    class SettingsSnapshot {
+    public:
+        using id_type = size_t;
+
+
+        // Accessors
+
+        template<typename T>
+        [[nodiscard]]
+        const T& get(id_type id) const { return std::get<T>(m_values[id]); }
+
+        template<typename T>
+        [[nodiscard]]
+        const T& get(std::string_view name) const {
+            auto id = find(name);
+            if (!id)
+                throw ers::make_out_of_range_error("Setting '{}' isn't registered", name);
+
+            return get<T>(*id);
+        }
+
+        [[nodiscard]]
+        const setting_value_t& operator[](id_type id) const { return m_values[id]; }
+
+        [[nodiscard]]
+        ers::optional<id_type> find(std::string_view name) const;
+
+
+        // Observers
+
+        [[nodiscard]]
+        size_t size() const noexcept { return m_values.size(); }
+
+        [[nodiscard]]
+        u64 version() const noexcept { return m_version; }
+
+
+    private:
+        friend class SettingsRegistry;
+
+        // Shared by snapshots until a setting is added.
+        ers::shared_ptr<const ers::StringMap<id_type>> m_ids;
+        std::vector<setting_value_t> m_values;
+        u64 m_version = 0;
+    };
+
+
+    class SettingsRegistry {
+    public:
+        using id_type = SettingsSnapshot::id_type;
+        using subscription_id = u64;
+        using callback_fn = ers::function<void(std::string_view name, const setting_value_t& value)>;
+
+
+        // Constructor
+
+        SettingsRegistry();
+
+        SettingsRegistry(const SettingsRegistry&) = delete;
+        SettingsRegistry& operator=(const SettingsRegistry&) = delete;
+
+
+        // Modifiers
+
+        // Throws if "name" is taken.
+        id_type add(std::string name, setting_t setting);
+
+        // False if "value" is rejected by the setting or is of another type, throws for unknown names.
+        // Integral values are taken for doubles.
+        bool set(id_type id, setting_value_t value);
+        bool set(std::string_view name, setting_value_t value);
+
+        void reset(id_type id);
+        void reset_all();
+
+        // "fn" is called after every change of the setting.
+        subscription_id subscribe(id_type id, callback_fn fn);
+        void unsubscribe(subscription_id subscription);
+
+        // Integral values are taken for doubles. Unknown names are skipped, so settings of removed features
+        // don't break old files; rejected values keep the current ones and are reported together.
+        ers::Status load(const utl::Json& json);
+
+
+        // Observers
+
+        [[nodiscard]]
+        utl::Json save() const;
+
+        [[nodiscard]]
+        ers::optional<id_type> find(std::string_view name) const;
+
+        [[nodiscard]]
+        ers::shared_ptr<const SettingsSnapshot> snapshot() const;
+
+        // Replaces "cached" if it's empty or outdated, returns whether it was replaced.
+        bool refresh(ers::shared_ptr<const SettingsSnapshot>& cached) const;
+
+
+    private:
+        enum class ApplyResult : u8 {
+            Rejected,
+            Unchanged,
+            Changed
+        };
+
+        struct entry_t {
+            std::string name;
+            setting_t setting;
+            std::vector<std::pair<subscription_id, callback_fn>> callbacks;
+        };
+
+        struct notification_t {
+            std::string name;
+            setting_value_t value;
+            std::vector<callback_fn> callbacks;
+        };
+
+
+        // mutex should be acquired already
+        [[nodiscard]]
+        id_type _id_of(std::string_view name) const;
+
+        // mutex should be acquired already
+        [[nodiscard]]
+        entry_t& _entry(id_type id);
+
+        // mutex should be acquired already
+        static ApplyResult _apply(entry_t& entry, const setting_value_t& value);
+
+        // mutex should be acquired already
+        [[nodiscard]]
+        static notification_t _notification_of(const entry_t& entry);
+
+        // mutex should be acquired already
+        void _publish();
+
+        // Called unlocked, callbacks may use the registry.
+        static void _notify(const std::vector<notification_t>& notifications);
+
+
+        mutable std::mutex m_mutex;
+        std::vector<entry_t> m_entries;
+        ers::shared_ptr<const ers::StringMap<id_type>> m_ids;
+        subscription_id m_next_subscription = 1;
+
+        ers::atomic_shared_ptr<const SettingsSnapshot> m_snapshot;
+        std::atomic<u64> m_version = 0;
+    };
+}
+
+
+// Exports
+
+namespace aengine {
+    using impl::setting_t;
+    using impl::setting_value_t;
+    using impl::SettingsSnapshot;
+    using impl::SettingsRegistry;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+// std
+#include <exception>
+#include <functional>
+#include <future>
+#include <span>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+// ers
+#include <erslib/aengine/dependency_graph.hpp>
+#include <erslib/aengine/mod.hpp>
+#include <erslib/core/thread_safe.hpp>
+
+
+// Runs "stage_group_t"s: groups one after another, mods of a group concurrently on a pool.
+//
+// "run(const Mod&, const std::string& phase, size_t index)" is called for every stage of a mod, in order,
+// on one thread. Its results are handed to "merge" on the calling thread after the whole group is over,
+// in the order the group lists its mods, so the outcome doesn't depend on scheduling. A failed group
+// rethrows its first failure in that same order, after every mod of the group has finished.
+//
+// Mods of one group run at the same time, so their runtimes must live in separate Lua states.
+
+namespace aengine::impl {
+    template<typename Run>
+    using stage_result_t = std::invoke_result_t<Run&, const Mod&, const std::string&, size_t>;
+
+
+    template<typename Run, typename Merge>
+    void execute_stage_groups(
+        const ModContainer& mods,
+        std::span<const stage_group_t> groups,
+        ers::thread_safe::WorkerPool& pool,
+        Run&& run,
+        Merge&& merge
+    ) {
+        using result_type = std::conditional_t<std::is_void_v<stage_result_t<Run>>, std::monostate, stage_result_t<Run>>;
+
+
+        auto run_mod = [&run](const Mod& mod, const stage_group_t& group, const mod_stages_t& stages) {
+            std::vector<result_type> results;
+            results.reserve(stages.indexes.size());
+
+            for (size_t index : stages.indexes) {
+                if constexpr (std::is_void_v<stage_result_t<Run>>) {
+                    std::invoke(run, mod, group.phase, index);
+                    results.emplace_back();
+                } else {
+                    results.push_back(std::invoke(run, mod, group.phase, index));
+                }
+            }
+
+            return results;
+        };
+
+
+        for (const auto& group : groups) {
+            std::vector<const Mod*> group_mods;
+            group_mods.reserve(group.mods.size());
+
+            for (const auto& stages : group.mods) {
+                auto it = mods.find(stages.mod);
+                if (it == mods.end())
+                    throw make_dependency_error("Mod '{}' is scheduled, but not loaded.", stages.mod);
+
+                group_mods.push_back(&*it);
+            }
+
+
+            // A lone mod isn't worth a round trip through the pool.
+
+            std::vector<std::vector<result_type>> results(group.mods.size());
+
+            if (group.mods.size() == 1) {
+                results[0] = run_mod(*group_mods[0], group, group.mods[0]);
+            } else {
+                std::vector<std::future<std::vector<result_type>>> pending;
+                pending.reserve(group.mods.size());
+
+                for (size_t i = 0; i < group.mods.size(); i++) {
+                    pending.push_back(pool.submit([&run_mod, &group, mod = group_mods[i], stages = &group.mods[i]] {
+                        return run_mod(*mod, group, *stages);
+                    }));
+                }
+
+                std::exception_ptr error = nullptr;
+
+                for (size_t i = 0; i < pending.size(); i++) {
+                    try {
+                        results[i] = pending[i].get();
+                    } catch (...) {
+                        if (!error)
+                            error = std::current_exception();
+                    }
+                }
+
+                if (error)
+                    std::rethrow_exception(error);
+            }
+
+
+            if constexpr (!std::is_void_v<stage_result_t<Run>>) {
+                for (size_t i = 0; i < group.mods.size(); i++) {
+                    for (size_t j = 0; j < results[i].size(); j++)
+                        std::invoke(merge, *group_mods[i], group.phase, group.mods[i].indexes[j], std::move(results[i][j]));
+                }
+            }
+        }
+    }
+
+    // For stages that don't produce anything to merge.
+    template<typename Run>
+        requires std::is_void_v<stage_result_t<Run>>
+    void execute_stage_groups(
+        const ModContainer& mods,
+        std::span<const stage_group_t> groups,
+        ers::thread_safe::WorkerPool& pool,
+        Run&& run
+    ) {
+        execute_stage_groups(mods, groups, pool, std::forward<Run>(run), [](auto&&...) {});
+    }
+}
+
+
+// Exports
+
+namespace aengine {
+    using impl::execute_stage_groups;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// sol
+#include <sol/state_view.hpp>
+#include <sol/table.hpp>
+
+
+// Globals visible to mods, built once per Lua state.
+//
+// The sandbox is a shallow copy of the state's globals without the unsafe ones, kept in the registry.
+// Mod environments fall back to it, so making one is a single table with no fields to hide. Library
+// tables ("string", "table", ...) are shared with the state: mods can still write into them, which
+// "restore_sandbox" undoes. "getfenv" is wrapped to give out the sandbox instead of the real globals.
+//
+// Restoring covers fields of the sandbox, of the library tables and of the real globals, metatables
+// of all of them, the string metatable and the globals of the main thread. Everything the host sets
+// up in the state has to be there before the sandbox is created, as later globals are wiped too.
+// Not covered are tables nested deeper than a library and environments given to functions with
+// "setfenv". The "debug" library reaches past all of it, states opening it must not be shared by
+// untrusted mods.
+
+namespace aengine::impl::util {
+    // Creates the sandbox on the first call for "lua".
+    sol::table sandbox_globals(sol::state_view lua);
+
+    // Puts the sandbox and the library tables it refers to back to how they were when it was created.
+    void restore_sandbox(sol::state_view lua);
+}
@@ -2,15 +2,39 @@
 
 // std
 #include <string>
+#include <string_view>
+#include <tuple>
+
+// ers
+#include <erslib/core/type/optional.hpp>
 
 
 // Stage is '<phase>-<index>'
 
 namespace aengine::impl::util {
+    struct stage_name_t {
+        std::string_view phase;
+        size_t index;
+    };
+
+    struct stage_info_t {
+        std::string phase;
+        size_t index;
+    };
+
+
+    // Splits at the last '-', the phase is non-empty and the index is a non-empty run of digits
+    // without leading zeros, so "make_stage_name" gives the same name back. "phase" is a slice of 'sv'.
+    ers::optional<stage_name_t> parse_stage_name(std::string_view sv);
+
+    // True for a stage name with leading zeros in its index ("data-01"), "parse_stage_name" rejects those.
+    bool has_padded_stage_index(std::string_view sv);
+
     bool is_stage_naming_scheme(std::string_view sv);
 
-    // Returns slice of 'sv'
     std::tuple<std::string, size_t> extract_stage_info(std::string_view sv);
+
+    std::string make_stage_name(std::string_view phase, size_t index);
 }
 
 
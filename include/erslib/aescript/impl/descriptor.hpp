@@ -7,11 +7,13 @@
 #include <sol/table.hpp>
 
 // ers
+#include <erslib/core/memory/pool_resource.hpp>
 #include <erslib/core/type/result.hpp>
 
 
 namespace aescript::impl {
-    using Descriptor = std::polymorphic<class IDescriptor>;
+    class IDescriptor;
+    using Descriptor = std::polymorphic<IDescriptor, ers::pool_allocator<IDescriptor>>;
 
     class IDescriptor {
     public:
@@ -11,6 +11,7 @@
 // ers
 #include <erslib/aescript/impl/parser.hpp>
 #include <erslib/aescript/impl/verifier.hpp>
+#include <erslib/core/memory/pool_resource.hpp>
 #include <erslib/core/type/result.hpp>
 
 
@@ -18,7 +19,11 @@
 
 namespace aescript::impl {
     class Field {
-        using storage_iterator = std::list<Verifier>::const_iterator;
+        // List nodes come from the same pool as the properties themselves.
+        template<typename T>
+        using storage_type = std::list<T, ers::pool_allocator<T>>;
+
+        using storage_iterator = storage_type<Verifier>::const_iterator;
 
 
     public:
@@ -57,10 +62,10 @@ namespace aescript::impl {
     private:
         std::string _name;
 
-        std::list<Verifier> _verifiers;
+        storage_type<Verifier> _verifiers;
         std::vector<storage_iterator> _verifiers_order;
 
-        std::list<Parser> _parsers;
+        storage_type<Parser> _parsers;
 
 
         void _copy_from(const Field& other);
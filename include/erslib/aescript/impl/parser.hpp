@@ -8,11 +8,13 @@
 
 // ers
 #include <erslib/aescript/impl/context.hpp>
+#include <erslib/core/memory/pool_resource.hpp>
 #include <erslib/core/type/result.hpp>
 
 
 namespace aescript::impl {
-    using Parser = std::polymorphic<class IParser>;
+    class IParser;
+    using Parser = std::polymorphic<IParser, ers::pool_allocator<IParser>>;
 
     class IParser {
     public:
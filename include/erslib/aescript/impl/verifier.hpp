@@ -8,11 +8,13 @@
 
 // ers
 #include <erslib/aescript/impl/context.hpp>
+#include <erslib/core/memory/pool_resource.hpp>
 #include <erslib/core/type/result.hpp>
 
 
 namespace aescript::impl {
-    using Verifier = std::polymorphic<class IVerifier>;
+    class IVerifier;
+    using Verifier = std::polymorphic<IVerifier, ers::pool_allocator<IVerifier>>;
 
     class IVerifier {
     public:
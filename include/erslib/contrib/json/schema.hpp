@@ -1,13 +1,13 @@
 #pragma once
 
 // std
-#include <functional>
-#include <list>
+#include <vector>
 
 // ers
 #include <erslib/contrib/json/concept.hpp>
 #include <erslib/contrib/json/impl.hpp>
 #include <erslib/core/concept/json.hpp>
+#include <erslib/core/memory/function.hpp>
 #include <erslib/core/meta/type_name.hpp>
 #include <erslib/core/trait/fn.hpp>
 #include <erslib/core/trait/result.hpp>
@@ -43,8 +43,8 @@ namespace utl::impl {
             const auto& object = m_json.as_object();
 
             if (auto r = _check<T>(object, name); r) {
-                m_assignments.emplace_back([&out, value = (*r)->second] {
-                    out = value.template as<T>();
+                m_assignments.emplace_back([&out, value = &(*r)->second] {
+                    out = value->template as<T>();
                 });
             }
         }
@@ -55,8 +55,8 @@ namespace utl::impl {
             const auto& object = m_json.as_object();
 
             if (auto r = _check<T>(object, name); r) {
-                m_assignments.emplace_back([&out, value = (*r)->second] {
-                    out = value.template as<T>();
+                m_assignments.emplace_back([&out, value = &(*r)->second] {
+                    out = value->template as<T>();
                 });
             } else
                 m_error = std::move(r.error());
@@ -75,8 +75,8 @@ namespace utl::impl {
             const auto& object = m_json.as_object();
 
             if (auto r = _check<json_type>(object, name); r) {
-                m_assignments.emplace_back([&out, writer = std::move(writer), value = (*r)->second] {
-                    if (auto r = writer(value.template as<json_type>()); r)
+                m_assignments.emplace_back([&out, writer = std::move(writer), value = &(*r)->second] {
+                    if (auto r = writer(value->template as<json_type>()); r)
                         out = *r;
                     else
                         throw ers::conversion_error(r.error().to_string(true));
@@ -101,7 +101,8 @@ namespace utl::impl {
     protected:
         const Node& m_json;
         std::optional<ers::Diagnostic> m_error;
-        std::list<std::function<void()>> m_assignments;
+        // Nodes are captured by pointer, "m_json" outlives the schema anyway.
+        std::vector<ers::function<void()>> m_assignments;
 
 
     private:
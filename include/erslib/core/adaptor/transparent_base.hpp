@@ -3,6 +3,7 @@
 // std
 #include <concepts>
 #include <functional>
+#include <span>
 #include <type_traits>
 
 // ers
@@ -154,6 +155,14 @@ namespace ers::impl {
 
 
         using Hash<std::remove_cvref_t<Ts>>::operator()...;
+
+        template<typename U>
+        void hash_many(
+            std::span<const U> what, std::span<size_t> out, size_t seed = 0
+        ) const noexcept(noexcept(Hash<U> {}.hash_many(what, out, seed))
+        ) requires requires { Hash<U> {}.hash_many(what, out, seed); } {
+            Hash<U> {}.hash_many(what, out, seed);
+        }
     };
 }
 
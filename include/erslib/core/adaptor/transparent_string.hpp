@@ -5,9 +5,10 @@
 
 // ers
 #include <erslib/core/adaptor/transparent_base.hpp>
+#include <erslib/core/hashing/base.hpp>
 
 
-#define ERS_STRING_LIKE_TYPES_PACK std::string, std::string_view, const char*
+#define ERS_STRING_LIKE_TYPES_PACK std::string, std::string_view, const char*, ::ers::hashing::prehashed_string
 
 
 namespace ers::impl::adaptor {
@@ -3,6 +3,7 @@
 
 // Includes
 
+#include <erslib/core/algorithm/bulk.hpp>
 #include <erslib/core/algorithm/container.hpp>
 #include <erslib/core/algorithm/hash.hpp>
 #include <erslib/core/algorithm/split/regular.hpp>
@@ -12,6 +13,9 @@
 // Exports
 
 namespace ers::algo {
+    using impl::algo::bulk_insert;
+    using impl::algo::bulk_find;
+
     using impl::algo::keys_sorted_by_value;
     using impl::algo::combine;
 
@@ -0,0 +1,105 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <array>
+#include <ranges>
+#include <span>
+#include <string_view>
+
+// ers
+#include <erslib/core/concept/pair.hpp>
+#include <erslib/core/hashing/base.hpp>
+
+
+// Bulk operations hash keys in chunks through "hasher::hash_many" and hand them to the container
+// as 'prehashed_string', so the container doesn't hash them a second time.
+
+namespace ers::impl::algo {
+    constexpr size_t bulk_chunk_size = 64;
+
+
+    template<typename Container>
+    concept BulkHashable = requires(
+        const typename Container::hasher& h,
+        std::span<const std::string_view> what,
+        std::span<size_t> out
+    ) {
+        h.hash_many(what, out);
+    };
+
+
+    // Returns amount of inserted keys.
+    template<typename Set>
+        requires BulkHashable<Set>
+    size_t bulk_insert(Set& set, std::span<const std::string_view> keys) {
+        std::array<size_t, bulk_chunk_size> hashes;
+        size_t inserted = 0;
+
+        set.reserve(set.size() + keys.size());
+
+
+        for (size_t offset = 0; offset < keys.size(); offset += bulk_chunk_size) {
+            const auto chunk = keys.subspan(offset, std::min(bulk_chunk_size, keys.size() - offset));
+            set.hash_function().hash_many(chunk, hashes);
+
+            for (size_t i = 0; i < chunk.size(); i++)
+                inserted += set.insert(hashing::prehashed_string { chunk[i], hashes[i] }).second;
+        }
+
+
+        return inserted;
+    }
+
+    // Same as above, but for maps, "items" is a range of pairs with string-like keys.
+    // Already existing keys keep their values.
+    template<typename Map, std::ranges::random_access_range R>
+        requires BulkHashable<Map> && PairLike<std::ranges::range_value_t<R>>
+    size_t bulk_insert(Map& map, R&& items) {
+        std::array<std::string_view, bulk_chunk_size> keys;
+        std::array<size_t, bulk_chunk_size> hashes;
+        size_t inserted = 0;
+
+        const size_t total = std::ranges::size(items);
+        map.reserve(map.size() + total);
+
+
+        for (size_t offset = 0; offset < total; offset += bulk_chunk_size) {
+            const size_t count = std::min(bulk_chunk_size, total - offset);
+
+            for (size_t i = 0; i < count; i++)
+                keys[i] = std::string_view(items[offset + i].first);
+
+            map.hash_function().hash_many(std::span<const std::string_view>(keys.data(), count), hashes);
+
+            for (size_t i = 0; i < count; i++) {
+                auto&& item = items[offset + i];
+                const hashing::prehashed_string key = { keys[i], hashes[i] };
+
+                if constexpr (std::is_rvalue_reference_v<R&&>)
+                    inserted += map.try_emplace(key, std::move(item.second)).second;
+                else
+                    inserted += map.try_emplace(key, item.second).second;
+            }
+        }
+
+
+        return inserted;
+    }
+
+
+    // Writes "container.find(key)" for every key into "out".
+    template<typename Container, typename OutIt>
+        requires BulkHashable<Container>
+    void bulk_find(Container& container, std::span<const std::string_view> keys, OutIt out) {
+        std::array<size_t, bulk_chunk_size> hashes;
+
+        for (size_t offset = 0; offset < keys.size(); offset += bulk_chunk_size) {
+            const auto chunk = keys.subspan(offset, std::min(bulk_chunk_size, keys.size() - offset));
+            container.hash_function().hash_many(chunk, hashes);
+
+            for (size_t i = 0; i < chunk.size(); i++)
+                *out++ = container.find(hashing::prehashed_string { chunk[i], hashes[i] });
+        }
+    }
+}
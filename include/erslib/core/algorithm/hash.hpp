@@ -1,19 +1,59 @@
 #pragma once
 
+// std
+#include <string_view>
+#include <type_traits>
+
+// ers
+#include <erslib/core/hashing/base.hpp>
+
 
 namespace ers::impl::algo {
+    template<typename T>
+    concept StreamableArg =
+        std::integral<T>
+        || std::is_enum_v<T>
+        || std::convertible_to<const T&, std::string_view>;
+
+    template<template<typename> typename HashEngine>
+    concept StreamableEngine =
+        requires { typename ers::hashing::policy_of_t<HashEngine<size_t>>; }
+        && ers::hashing::StreamBackend<ers::hashing::policy_of_t<HashEngine<size_t>>>;
+
+
+    // Hashes the arguments as one concatenated input when the engine supports streaming,
+    // otherwise mixes per-argument hashes. Strings are prefixed with their length,
+    // so ("ab", "c") and ("a", "bc") don't collide.
     template<template<typename> typename HashEngine, typename... Args>
     constexpr size_t combine(const Args&... args) noexcept {
-        size_t r = 0;
+        if constexpr (StreamableEngine<HashEngine> && (StreamableArg<Args> && ...)) {
+            THashStream<ers::hashing::policy_of_t<HashEngine<size_t>>> stream;
+
+
+            auto combine_step = [&stream]<typename T>(const T& arg) {
+                if constexpr (std::convertible_to<const T&, std::string_view>) {
+                    const std::string_view sv = arg;
+                    stream.update(sv.size()).update(sv);
+                } else
+                    stream.update(arg);
+            };
+
+            (combine_step(args), ...);
+
+
+            return stream.finalize();
+        } else {
+            size_t r = 0;
 
 
-        auto combine_step = [&r]<typename T>(const T& arg) {
-            r ^= HashEngine<T> {}(arg) + 0x9e3779b97f4a7c15 + (r << 6) + (r >> 2);
-        };
+            auto combine_step = [&r]<typename T>(const T& arg) {
+                r ^= HashEngine<T> {}(arg) + 0x9e3779b97f4a7c15 + (r << 6) + (r >> 2);
+            };
 
-        (combine_step(args), ...);
+            (combine_step(args), ...);
 
 
-        return r;
+            return r;
+        }
     }
 }
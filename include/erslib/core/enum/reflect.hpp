@@ -15,6 +15,7 @@
 // ers
 #include <erslib/core/meta.hpp>
 #include <erslib/core/type/optional.hpp>
+#include <erslib/core/type/const_string_map.hpp>
 #include <erslib/core/convert/string.hpp>
 #include <erslib/core/enum/fwd.hpp>
 #include <erslib/core/enum/case_styles.hpp>
@@ -72,6 +73,24 @@ namespace ers::impl::enum_utils {
     struct name_table {
         static constexpr auto value = build_name_table<E>();
     };
+
+
+    // Perfect-hash index over "name_table", so "from_string" doesn't scan every enumerator.
+    template<typename E>
+    consteval auto build_name_index() {
+        constexpr auto& table = name_table<E>::value;
+        std::array<std::pair<std::string_view, E>, table.size()> items {};
+
+        for (size_t i = 0; i < table.size(); i++)
+            items[i] = { table[i].second, table[i].first };
+
+        return ConstStringMap<E, table.size()>(items);
+    }
+
+    template<typename E>
+    struct name_index {
+        static constexpr auto value = build_name_index<E>();
+    };
 }
 
 
@@ -90,10 +109,8 @@ namespace ers::impl::enum_utils {
 
     template<typename E>
     constexpr optional<E> from_string(std::string_view name) {
-        for (const auto& [v, n] : name_table<E>::value) {
-            if (n == name)
-                return v;
-        }
+        if (auto it = name_index<E>::value.find(name); it != name_index<E>::value.end())
+            return it->second;
 
         return nullopt;
     }
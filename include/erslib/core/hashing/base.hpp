@@ -6,7 +6,9 @@
 #include <cstring>
 #include <span>
 #include <string>
+#include <string_view>
 #include <utility>
+#include <vector>
 
 
 // Definition
@@ -19,12 +21,62 @@ namespace ers::hashing {
     concept RawBytesBackend = requires(std::span<const std::byte> what, size_t seed) {
         { backend<Policy>::process_raw_bytes(what, seed) } -> std::same_as<size_t>;
     };
+
+    // Backends that can hash input fed in several pieces, see 'THashStream'.
+    template<typename Policy>
+    concept StreamBackend = requires(typename backend<Policy>::stream_type stream, const std::byte* p, size_t len) {
+        stream.init(len);
+        stream.update(p, len);
+        { stream.finalize() } -> std::convertible_to<size_t>;
+    };
+
+    // Backends that can hash several strings per call, faster than hashing them one by one.
+    template<typename Policy, typename Str>
+    concept BatchBackend = requires(std::span<const Str> what, std::span<size_t> out, size_t seed) {
+        backend<Policy>::process_raw_bytes_many(what, out, seed);
+    };
+
+
+    // String with an already computed hash, used as heterogeneous key
+    // so that containers don't hash it again (see 'algo::bulk_insert').
+    struct prehashed_string {
+        std::string_view key;
+        size_t hash;
+
+
+        constexpr operator std::string_view() const noexcept { return key; }
+
+        friend constexpr bool operator==(const prehashed_string& lhs, std::string_view rhs) noexcept {
+            return lhs.key == rhs;
+        }
+        friend constexpr bool operator==(const prehashed_string& lhs, const prehashed_string& rhs) noexcept {
+            return lhs.key == rhs.key;
+        }
+    };
 }
 
 
 namespace ers {
     template<typename T, typename Policy>
     struct THashBase {};
+
+    template<typename Policy>
+        requires hashing::StreamBackend<Policy>
+    class THashStream;
+}
+
+
+namespace ers::hashing {
+    template<typename Hasher>
+    struct policy_of {};
+
+    template<typename T, typename Policy>
+    struct policy_of<THashBase<T, Policy>> {
+        using type = Policy;
+    };
+
+    template<typename Hasher>
+    using policy_of_t = policy_of<Hasher>::type;
 }
 
 
@@ -87,18 +139,38 @@ template<typename Policy>
 struct ers::THashBase<std::string_view, Policy> {
     using type = std::string_view;
 
-    size_t operator()(
+    constexpr size_t operator()(
         type what, size_t seed = 0
     ) const noexcept requires (hashing::RawBytesBackend<Policy>) {
-        const auto bytes = reinterpret_cast<const std::byte*>(what.data());
-        return hashing::backend<Policy>::process_raw_bytes({ bytes, what.size() }, seed);
+        if consteval {
+            // Can't reinterpret chars as bytes during constant evaluation, so copy them.
+            std::vector<std::byte> bytes(what.size());
+
+            for (size_t i = 0; i < what.size(); i++)
+                bytes[i] = static_cast<std::byte>(what[i]);
+
+            return hashing::backend<Policy>::process_raw_bytes({ bytes.data(), bytes.size() }, seed);
+        } else {
+            const auto bytes = reinterpret_cast<const std::byte*>(what.data());
+            return hashing::backend<Policy>::process_raw_bytes({ bytes, what.size() }, seed);
+        }
     }
 
-    size_t operator()(
+    constexpr size_t operator()(
         type what, size_t seed = 0
     ) const noexcept requires (!hashing::RawBytesBackend<Policy>) {
         return hashing::backend<Policy>::process_value(what, seed);
     }
+
+    // "out" must be at least as big as "what".
+    void hash_many(std::span<const type> what, std::span<size_t> out, size_t seed = 0) const noexcept {
+        if constexpr (hashing::BatchBackend<Policy, type>) {
+            hashing::backend<Policy>::process_raw_bytes_many(what, out.first(what.size()), seed);
+        } else {
+            for (size_t i = 0; i < what.size(); i++)
+                out[i] = (*this)(what[i], seed);
+        }
+    }
 };
 
 template<typename Policy>
@@ -117,6 +189,25 @@ struct ers::THashBase<std::string, Policy> {
     ) const requires (!hashing::RawBytesBackend<Policy>) {
         return hashing::backend<Policy>::process_value(what, seed);
     }
+
+    // "out" must be at least as big as "what".
+    void hash_many(std::span<const type> what, std::span<size_t> out, size_t seed = 0) const {
+        if constexpr (hashing::BatchBackend<Policy, type>) {
+            hashing::backend<Policy>::process_raw_bytes_many(what, out.first(what.size()), seed);
+        } else {
+            for (size_t i = 0; i < what.size(); i++)
+                out[i] = (*this)(what[i], seed);
+        }
+    }
+};
+
+template<typename Policy>
+struct ers::THashBase<ers::hashing::prehashed_string, Policy> {
+    using type = hashing::prehashed_string;
+
+    constexpr size_t operator()(const type& what, size_t /*seed*/ = 0) const noexcept {
+        return what.hash;
+    }
 };
 
 
@@ -147,3 +238,68 @@ struct ers::THashBase<T, Policy> {
         return ers::THashBase<std::underlying_type_t<T>, Policy> {}(std::to_underlying(what), seed);
     }
 };
+
+
+// Incremental hashing
+//
+// Produces the same value as hashing all fed bytes at once, so it can be used for
+// input that comes in pieces (file chunks, multi-part keys) without concatenating it.
+
+template<typename Policy>
+    requires ers::hashing::StreamBackend<Policy>
+class ers::THashStream {
+    using stream_type = hashing::backend<Policy>::stream_type;
+
+
+public:
+    constexpr explicit THashStream(size_t seed = 0) noexcept {
+        init(seed);
+    }
+
+
+    // Modifiers
+
+    constexpr void init(size_t seed = 0) noexcept {
+        m_stream.init(seed);
+    }
+
+    constexpr THashStream& update(std::span<const std::byte> what) noexcept {
+        m_stream.update(what.data(), what.size());
+        return *this;
+    }
+    constexpr THashStream& update(std::string_view what) noexcept {
+        if consteval {
+            // Same as for 'THashBase<std::string_view>', chars are copied as they can't be reinterpreted.
+            std::vector<std::byte> bytes(what.size());
+
+            for (size_t i = 0; i < what.size(); i++)
+                bytes[i] = static_cast<std::byte>(what[i]);
+
+            m_stream.update(bytes.data(), bytes.size());
+        } else {
+            m_stream.update(reinterpret_cast<const std::byte*>(what.data()), what.size());
+        }
+
+        return *this;
+    }
+
+    template<typename T>
+        requires (std::integral<T> || std::is_enum_v<T>)
+    constexpr THashStream& update(T what) noexcept {
+        const auto bytes = std::bit_cast<std::array<std::byte, sizeof(T)>>(what);
+        m_stream.update(bytes.data(), bytes.size());
+        return *this;
+    }
+
+
+    // Observers
+
+    [[nodiscard]]
+    constexpr size_t finalize() const noexcept {
+        return m_stream.finalize();
+    }
+
+
+private:
+    stream_type m_stream;
+};
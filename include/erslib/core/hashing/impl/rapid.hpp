@@ -30,6 +30,7 @@
 #pragma once
 
 // std
+#include <cstddef>
 #include <cstdint>
 
 // ers
@@ -39,6 +40,8 @@
 /*
  *  Unrolled macro.
  *  Improves large input speed, but increases code size and worsens small input speed.
+ *  Only selects the default of 'rapidhash', 'rapid_full_policy' and 'rapid_unrolled_policy'
+ *  pick the variant explicitly.
  *
  *  RAPIDHASH_COMPACT: Normal behavior.
  *  RAPIDHASH_UNROLLED:
@@ -244,9 +247,17 @@ namespace ers::impl::hashing {
     }
 #endif
 
+#ifdef RAPIDHASH_UNROLLED
+    constexpr bool rapid_unrolled_default = true;
+#else
+    constexpr bool rapid_unrolled_default = false;
+#endif
+
     /*
      *  rapidhash main function.
      *
+     *  @tparam Unrolled  Process 224 bytes per iteration instead of 112, see RAPIDHASH_UNROLLED.
+     *
      *  @param key     Buffer to be hashed.
      *  @param len     @key length, in bytes.
      *  @param seed    64-bit seed used to alter the hash result predictably.
@@ -254,6 +265,7 @@ namespace ers::impl::hashing {
      *
      *  Returns a 64-bit hash.
      */
+    template<bool Unrolled = rapid_unrolled_default>
     constexpr u64 rapidhash(const std::byte* p, size_t len, u64 seed, const u64* secret) noexcept {
         seed ^= rapid_mix(seed ^ secret[2], secret[1]);
         u64 a = 0, b = 0;
@@ -283,49 +295,49 @@ namespace ers::impl::hashing {
                 u64 see3 = seed, see4 = seed;
                 u64 see5 = seed, see6 = seed;
 
-#ifdef RAPIDHASH_COMPACT
-                do {
-                    seed = rapid_mix(rapid_read64(p) ^ secret[0], rapid_read64(p + 8) ^ seed);
-                    see1 = rapid_mix(rapid_read64(p + 16) ^ secret[1], rapid_read64(p + 24) ^ see1);
-                    see2 = rapid_mix(rapid_read64(p + 32) ^ secret[2], rapid_read64(p + 40) ^ see2);
-                    see3 = rapid_mix(rapid_read64(p + 48) ^ secret[3], rapid_read64(p + 56) ^ see3);
-                    see4 = rapid_mix(rapid_read64(p + 64) ^ secret[4], rapid_read64(p + 72) ^ see4);
-                    see5 = rapid_mix(rapid_read64(p + 80) ^ secret[5], rapid_read64(p + 88) ^ see5);
-                    see6 = rapid_mix(rapid_read64(p + 96) ^ secret[6], rapid_read64(p + 104) ^ see6);
-                    p += 112;
-                    i -= 112;
-                } while (i > 112);
-#else
-                while (i > 224) {
-                    seed = rapid_mix(rapid_read64(p) ^ secret[0], rapid_read64(p + 8) ^ seed);
-                    see1 = rapid_mix(rapid_read64(p + 16) ^ secret[1], rapid_read64(p + 24) ^ see1);
-                    see2 = rapid_mix(rapid_read64(p + 32) ^ secret[2], rapid_read64(p + 40) ^ see2);
-                    see3 = rapid_mix(rapid_read64(p + 48) ^ secret[3], rapid_read64(p + 56) ^ see3);
-                    see4 = rapid_mix(rapid_read64(p + 64) ^ secret[4], rapid_read64(p + 72) ^ see4);
-                    see5 = rapid_mix(rapid_read64(p + 80) ^ secret[5], rapid_read64(p + 88) ^ see5);
-                    see6 = rapid_mix(rapid_read64(p + 96) ^ secret[6], rapid_read64(p + 104) ^ see6);
-                    seed = rapid_mix(rapid_read64(p + 112) ^ secret[0], rapid_read64(p + 120) ^ seed);
-                    see1 = rapid_mix(rapid_read64(p + 128) ^ secret[1], rapid_read64(p + 136) ^ see1);
-                    see2 = rapid_mix(rapid_read64(p + 144) ^ secret[2], rapid_read64(p + 152) ^ see2);
-                    see3 = rapid_mix(rapid_read64(p + 160) ^ secret[3], rapid_read64(p + 168) ^ see3);
-                    see4 = rapid_mix(rapid_read64(p + 176) ^ secret[4], rapid_read64(p + 184) ^ see4);
-                    see5 = rapid_mix(rapid_read64(p + 192) ^ secret[5], rapid_read64(p + 200) ^ see5);
-                    see6 = rapid_mix(rapid_read64(p + 208) ^ secret[6], rapid_read64(p + 216) ^ see6);
-                    p += 224;
-                    i -= 224;
-                }
-                if (i > 112) {
-                    seed = rapid_mix(rapid_read64(p) ^ secret[0], rapid_read64(p + 8) ^ seed);
-                    see1 = rapid_mix(rapid_read64(p + 16) ^ secret[1], rapid_read64(p + 24) ^ see1);
-                    see2 = rapid_mix(rapid_read64(p + 32) ^ secret[2], rapid_read64(p + 40) ^ see2);
-                    see3 = rapid_mix(rapid_read64(p + 48) ^ secret[3], rapid_read64(p + 56) ^ see3);
-                    see4 = rapid_mix(rapid_read64(p + 64) ^ secret[4], rapid_read64(p + 72) ^ see4);
-                    see5 = rapid_mix(rapid_read64(p + 80) ^ secret[5], rapid_read64(p + 88) ^ see5);
-                    see6 = rapid_mix(rapid_read64(p + 96) ^ secret[6], rapid_read64(p + 104) ^ see6);
-                    p += 112;
-                    i -= 112;
+                if constexpr (!Unrolled) {
+                    do {
+                        seed = rapid_mix(rapid_read64(p) ^ secret[0], rapid_read64(p + 8) ^ seed);
+                        see1 = rapid_mix(rapid_read64(p + 16) ^ secret[1], rapid_read64(p + 24) ^ see1);
+                        see2 = rapid_mix(rapid_read64(p + 32) ^ secret[2], rapid_read64(p + 40) ^ see2);
+                        see3 = rapid_mix(rapid_read64(p + 48) ^ secret[3], rapid_read64(p + 56) ^ see3);
+                        see4 = rapid_mix(rapid_read64(p + 64) ^ secret[4], rapid_read64(p + 72) ^ see4);
+                        see5 = rapid_mix(rapid_read64(p + 80) ^ secret[5], rapid_read64(p + 88) ^ see5);
+                        see6 = rapid_mix(rapid_read64(p + 96) ^ secret[6], rapid_read64(p + 104) ^ see6);
+                        p += 112;
+                        i -= 112;
+                    } while (i > 112);
+                } else {
+                    while (i > 224) {
+                        seed = rapid_mix(rapid_read64(p) ^ secret[0], rapid_read64(p + 8) ^ seed);
+                        see1 = rapid_mix(rapid_read64(p + 16) ^ secret[1], rapid_read64(p + 24) ^ see1);
+                        see2 = rapid_mix(rapid_read64(p + 32) ^ secret[2], rapid_read64(p + 40) ^ see2);
+                        see3 = rapid_mix(rapid_read64(p + 48) ^ secret[3], rapid_read64(p + 56) ^ see3);
+                        see4 = rapid_mix(rapid_read64(p + 64) ^ secret[4], rapid_read64(p + 72) ^ see4);
+                        see5 = rapid_mix(rapid_read64(p + 80) ^ secret[5], rapid_read64(p + 88) ^ see5);
+                        see6 = rapid_mix(rapid_read64(p + 96) ^ secret[6], rapid_read64(p + 104) ^ see6);
+                        seed = rapid_mix(rapid_read64(p + 112) ^ secret[0], rapid_read64(p + 120) ^ seed);
+                        see1 = rapid_mix(rapid_read64(p + 128) ^ secret[1], rapid_read64(p + 136) ^ see1);
+                        see2 = rapid_mix(rapid_read64(p + 144) ^ secret[2], rapid_read64(p + 152) ^ see2);
+                        see3 = rapid_mix(rapid_read64(p + 160) ^ secret[3], rapid_read64(p + 168) ^ see3);
+                        see4 = rapid_mix(rapid_read64(p + 176) ^ secret[4], rapid_read64(p + 184) ^ see4);
+                        see5 = rapid_mix(rapid_read64(p + 192) ^ secret[5], rapid_read64(p + 200) ^ see5);
+                        see6 = rapid_mix(rapid_read64(p + 208) ^ secret[6], rapid_read64(p + 216) ^ see6);
+                        p += 224;
+                        i -= 224;
+                    }
+                    if (i > 112) {
+                        seed = rapid_mix(rapid_read64(p) ^ secret[0], rapid_read64(p + 8) ^ seed);
+                        see1 = rapid_mix(rapid_read64(p + 16) ^ secret[1], rapid_read64(p + 24) ^ see1);
+                        see2 = rapid_mix(rapid_read64(p + 32) ^ secret[2], rapid_read64(p + 40) ^ see2);
+                        see3 = rapid_mix(rapid_read64(p + 48) ^ secret[3], rapid_read64(p + 56) ^ see3);
+                        see4 = rapid_mix(rapid_read64(p + 64) ^ secret[4], rapid_read64(p + 72) ^ see4);
+                        see5 = rapid_mix(rapid_read64(p + 80) ^ secret[5], rapid_read64(p + 88) ^ see5);
+                        see6 = rapid_mix(rapid_read64(p + 96) ^ secret[6], rapid_read64(p + 104) ^ see6);
+                        p += 112;
+                        i -= 112;
+                    }
                 }
-#endif
 
                 seed ^= see1;
                 see2 ^= see3;
@@ -502,4 +514,197 @@ namespace ers::impl::hashing {
         rapid_mum(&a, &b);
         return rapid_mix(a ^ secret[7], b ^ secret[1] ^ i);
     }
+
+    /*
+     *  Any rapidhash variant over a batch of keys.
+     *
+     *  @tparam Lanes     Amount of keys hashed per call.
+     *  @tparam Fallback  Variant used for keys longer than 16 bytes.
+     *
+     *  @param p       Array of @Lanes buffers to be hashed.
+     *  @param len     Array of @Lanes buffer lengths, in bytes.
+     *  @param seed    64-bit seed used to alter the hash result predictably.
+     *  @param secret  Triplet of 64-bit secrets used to alter hash result predictably.
+     *  @param out     Array of @Lanes 64-bit hashes.
+     *
+     *  Keys up to 16 bytes are hashed in lockstep: the lanes share the seed premix and their
+     *  multiplications are independent, so they overlap in the pipeline instead of waiting on
+     *  each other. All variants share the same path for such keys, so only longer ones are rehashed
+     *  with @Fallback and every result is identical to hashing the keys one by one.
+     */
+    template<size_t Lanes, auto Fallback>
+    constexpr void rapidhash_batch(
+        const std::byte* const* p, const size_t* len, u64 seed, const u64* secret, u64* out
+    ) noexcept {
+        const u64 mixed = seed ^ rapid_mix(seed ^ secret[2], secret[1]);
+
+        u64 a[Lanes] = {}, b[Lanes] = {}, s[Lanes];
+
+        for (size_t k = 0; k < Lanes; k++) {
+            s[k] = mixed;
+
+            if (len[k] >= 4) {
+                s[k] ^= len[k];
+                if (len[k] >= 8) {
+                    a[k] = rapid_read64(p[k]);
+                    b[k] = rapid_read64(p[k] + len[k] - 8);
+                } else {
+                    a[k] = rapid_read32(p[k]);
+                    b[k] = rapid_read32(p[k] + len[k] - 4);
+                }
+            } else if (len[k] > 0) {
+                a[k] = static_cast<u64>(p[k][0]) << 45 | static_cast<u64>(p[k][len[k] - 1]);
+                b[k] = static_cast<u64>(p[k][len[k] >> 1]);
+            }
+        }
+
+        for (size_t k = 0; k < Lanes; k++) {
+            a[k] ^= secret[1];
+            b[k] ^= s[k];
+            rapid_mum(&a[k], &b[k]);
+        }
+
+        for (size_t k = 0; k < Lanes; k++)
+            out[k] = rapid_mix(a[k] ^ secret[7], b[k] ^ secret[1] ^ len[k]);
+
+        for (size_t k = 0; k < Lanes; k++)
+            if (_unlikely_(len[k] > 16))
+                out[k] = Fallback(p[k], len[k], seed, secret);
+    }
+
+    /*
+     *  Incremental rapidhash.
+     *
+     *  @tparam Lanes  Amount of 16-byte lanes per block: 3 for nano, 5 for micro, 7 for full.
+     *
+     *  Bulk loops of all variants consume a block only while more than a block is left, and the
+     *  final step reads the last 16 bytes, which may reach back into the previous block. So the
+     *  stream holds back up to one block plus the 16 bytes before it, and the result is identical
+     *  to hashing the concatenated input in one call.
+     */
+    template<size_t Lanes>
+    class rapidhash_stream {
+        static_assert(Lanes == 3 || Lanes == 5 || Lanes == 7, "only nano, micro and full layouts exist");
+
+        static constexpr size_t block_size = Lanes * 16;
+        static constexpr size_t history_size = 16;
+
+        // Secrets used by the tail mixes, shared prefix of all variants.
+        static constexpr size_t tail_secrets[6] = { 2, 2, 1, 1, 2, 1 };
+
+
+    public:
+        constexpr rapidhash_stream() noexcept = default;
+        constexpr explicit rapidhash_stream(u64 seed, const u64* secret = rapid_secret) noexcept {
+            init(seed, secret);
+        }
+
+
+        constexpr void init(u64 seed, const u64* secret = rapid_secret) noexcept {
+            m_secret = secret;
+            m_seed = seed ^ rapid_mix(seed ^ secret[2], secret[1]);
+
+            for (auto& it : m_see)
+                it = m_seed;
+
+            m_total = 0;
+            m_pending = 0;
+        }
+
+        constexpr void update(const std::byte* p, size_t len) noexcept {
+            m_total += len;
+
+            while (m_pending + len > block_size) {
+                if (m_pending == 0) {
+                    _process_block(p);
+
+                    for (size_t k = 0; k < history_size; k++)
+                        m_buffer[k] = p[block_size - history_size + k];
+
+                    p += block_size;
+                    len -= block_size;
+                } else {
+                    const size_t fill = block_size - m_pending;
+
+                    for (size_t k = 0; k < fill; k++)
+                        m_buffer[history_size + m_pending + k] = p[k];
+
+                    _process_block(m_buffer + history_size);
+
+                    for (size_t k = 0; k < history_size; k++)
+                        m_buffer[k] = m_buffer[block_size + k];
+
+                    p += fill;
+                    len -= fill;
+                    m_pending = 0;
+                }
+            }
+
+            for (size_t k = 0; k < len; k++)
+                m_buffer[history_size + m_pending + k] = p[k];
+
+            m_pending += len;
+        }
+
+        [[nodiscard]]
+        constexpr u64 finalize() const noexcept {
+            const u64* secret = m_secret;
+            const std::byte* p = m_buffer + history_size;
+
+            u64 seed = m_seed;
+            u64 a = 0, b = 0;
+            size_t i = m_pending;
+
+            if (_likely_(m_total <= 16)) {
+                const size_t len = m_pending;
+
+                if (len >= 4) {
+                    seed ^= len;
+                    if (len >= 8) {
+                        a = rapid_read64(p);
+                        b = rapid_read64(p + len - 8);
+                    } else {
+                        a = rapid_read32(p);
+                        b = rapid_read32(p + len - 4);
+                    }
+                } else if (len > 0) {
+                    a = static_cast<u64>(p[0]) << 45 | static_cast<u64>(p[len - 1]);
+                    b = static_cast<u64>(p[len >> 1]);
+                }
+            } else {
+                if (m_total > block_size) {
+                    for (auto it : m_see)
+                        seed ^= it;
+                }
+
+                for (size_t k = 0; k + 1 < Lanes && i > 16 * (k + 1); k++)
+                    seed = rapid_mix(rapid_read64(p + 16 * k) ^ secret[tail_secrets[k]], rapid_read64(p + 16 * k + 8) ^ seed);
+
+                a = rapid_read64(p + i - 16) ^ i;
+                b = rapid_read64(p + i - 8);
+            }
+
+            a ^= secret[1];
+            b ^= seed;
+            rapid_mum(&a, &b);
+            return rapid_mix(a ^ secret[7], b ^ secret[1] ^ i);
+        }
+
+
+    private:
+        const u64* m_secret = rapid_secret;
+        u64 m_seed = 0;
+        u64 m_see[Lanes - 1] = {};
+        size_t m_total = 0;
+        size_t m_pending = 0;
+        std::byte m_buffer[history_size + block_size] = {};
+
+
+        constexpr void _process_block(const std::byte* p) noexcept {
+            m_seed = rapid_mix(rapid_read64(p) ^ m_secret[0], rapid_read64(p + 8) ^ m_seed);
+
+            for (size_t k = 1; k < Lanes; k++)
+                m_see[k - 1] = rapid_mix(rapid_read64(p + 16 * k) ^ m_secret[k], rapid_read64(p + 16 * k + 8) ^ m_see[k - 1]);
+        }
+    };
 }
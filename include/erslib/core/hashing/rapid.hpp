@@ -12,16 +12,75 @@
 // Algos usage
 
 namespace ers::impl {
+    // General purpose, best for keys up to ~80 bytes.
     struct rapid_hash_policy {};
+
+    // Smallest code size, best for short names and identifiers.
+    struct rapid_nano_policy {};
+
+    // Full rapidhash, catches up with micro on keys over ~112 bytes.
+    struct rapid_full_policy {};
+
+    // Full rapidhash unrolled by two, best for bulk data like file contents.
+    struct rapid_unrolled_policy {};
 }
 
 
+namespace ers::impl::hashing {
+    template<auto Fn, size_t StreamLanes>
+    struct rapid_backend {
+        using stream_type = rapidhash_stream<StreamLanes>;
+
+        static constexpr size_t batch_lanes = 4;
+
+
+        static constexpr size_t process_raw_bytes(std::span<const std::byte> what, size_t seed) noexcept {
+            return Fn(what.data(), what.size(), seed, rapid_secret);
+        }
+
+        template<typename Str>
+        static void process_raw_bytes_many(std::span<const Str> what, std::span<size_t> out, size_t seed) noexcept {
+            const std::byte* ptrs[batch_lanes];
+            size_t lens[batch_lanes];
+            u64 hashes[batch_lanes];
+
+            size_t i = 0;
+            for (; i + batch_lanes <= what.size(); i += batch_lanes) {
+                for (size_t k = 0; k < batch_lanes; k++) {
+                    ptrs[k] = reinterpret_cast<const std::byte*>(what[i + k].data());
+                    lens[k] = what[i + k].size();
+                }
+
+                rapidhash_batch<batch_lanes, Fn>(ptrs, lens, seed, rapid_secret, hashes);
+
+                for (size_t k = 0; k < batch_lanes; k++)
+                    out[i + k] = hashes[k];
+            }
+
+            for (; i < what.size(); i++) {
+                const auto bytes = reinterpret_cast<const std::byte*>(what[i].data());
+                out[i] = process_raw_bytes({ bytes, what[i].size() }, seed);
+            }
+        }
+    };
+}
+
+
+template<>
+struct ers::hashing::backend<ers::impl::rapid_hash_policy>
+    : ers::impl::hashing::rapid_backend<ers::impl::hashing::rapidhash_micro, 5> {};
+
+template<>
+struct ers::hashing::backend<ers::impl::rapid_nano_policy>
+    : ers::impl::hashing::rapid_backend<ers::impl::hashing::rapidhash_nano, 3> {};
+
+template<>
+struct ers::hashing::backend<ers::impl::rapid_full_policy>
+    : ers::impl::hashing::rapid_backend<ers::impl::hashing::rapidhash<false>, 7> {};
+
 template<>
-struct ers::hashing::backend<ers::impl::rapid_hash_policy> {
-    static constexpr size_t process_raw_bytes(std::span<const std::byte> what, size_t seed) noexcept {
-        return impl::hashing::rapidhash_micro(what.data(), what.size(), seed, impl::hashing::rapid_secret);
-    }
-};
+struct ers::hashing::backend<ers::impl::rapid_unrolled_policy>
+    : ers::impl::hashing::rapid_backend<ers::impl::hashing::rapidhash<true>, 7> {};
 
 
 // Declaration
@@ -29,9 +88,36 @@ struct ers::hashing::backend<ers::impl::rapid_hash_policy> {
 namespace ers::impl {
     template<typename T>
     using RapidHash = THashBase<T, rapid_hash_policy>;
+
+    template<typename T>
+    using RapidNanoHash = THashBase<T, rapid_nano_policy>;
+
+    template<typename T>
+    using RapidFullHash = THashBase<T, rapid_full_policy>;
+
+    template<typename T>
+    using RapidUnrolledHash = THashBase<T, rapid_unrolled_policy>;
+
+
+    using RapidHashStream = THashStream<rapid_hash_policy>;
+    using RapidNanoHashStream = THashStream<rapid_nano_policy>;
+    using RapidFullHashStream = THashStream<rapid_full_policy>;
+    using RapidUnrolledHashStream = THashStream<rapid_unrolled_policy>;
 }
 
 namespace ers {
     using impl::rapid_hash_policy;
+    using impl::rapid_nano_policy;
+    using impl::rapid_full_policy;
+    using impl::rapid_unrolled_policy;
+
     using impl::RapidHash;
+    using impl::RapidNanoHash;
+    using impl::RapidFullHash;
+    using impl::RapidUnrolledHash;
+
+    using impl::RapidHashStream;
+    using impl::RapidNanoHashStream;
+    using impl::RapidFullHashStream;
+    using impl::RapidUnrolledHashStream;
 }
@@ -5,7 +5,11 @@
 
 #include <erslib/core/memory/any.hpp>
 #include <erslib/core/memory/deleter.hpp>
+#include <erslib/core/memory/function.hpp>
 #include <erslib/core/memory/holder.hpp>
+#include <erslib/core/memory/mapped_file.hpp>
+#include <erslib/core/memory/pool_resource.hpp>
+#include <erslib/core/memory/scratch_arena.hpp>
 #include <erslib/core/memory/shared_ptr.hpp>
 
 
@@ -17,8 +21,23 @@ namespace ers {
 
     using impl::deleter;
 
+    using impl::TFunction;
+    using impl::function;
+    using impl::move_only_function;
+
     using impl::holder_ptr;
     using impl::make_holder;
+    using impl::make_polymorphic_holder;
+    using impl::make_pooled_holder;
+    using impl::make_pooled_polymorphic_holder;
+
+    using impl::MappedFile;
+
+    using impl::SizeClassResource;
+    using impl::size_class_resource;
+    using impl::pool_allocator;
+
+    using impl::ScratchArena;
 
     using impl::shared_ptr;
     using impl::atomic_shared_ptr;
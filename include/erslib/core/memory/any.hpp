@@ -9,6 +9,7 @@
 #include <erslib/core/assert.hpp>
 #include <erslib/core/meta.hpp>
 #include <erslib/core/concept/sbo.hpp>
+#include <erslib/core/memory/pool_resource.hpp>
 
 
 // Forward declaration
@@ -117,7 +118,7 @@ namespace ers::impl {
                 auto old_mr = obj.m_mr;
 
                 void* old_heap = obj.m_storage.heap;
-                void* new_heap = obj.m_mr->allocate(sizeof(T), alignof(T));
+                void* new_heap = mr->allocate(sizeof(T), alignof(T));
 
                 if constexpr (std::is_trivially_copyable_v<T>)
                     std::memcpy(new_heap, old_heap, sizeof(T));
@@ -165,6 +166,7 @@ namespace ers::impl {
 // Implementation
 
 namespace ers::impl {
+    // Values that don't fit into the buffer go to "SizeClassResource", unless another resource is provided.
     template<size_t Size, size_t Align>
     class TAny {
         using storage_type = TAnyStorage<Size, Align>;
@@ -236,7 +238,7 @@ namespace ers::impl {
 
         template<typename T>
             requires (!std::is_same_v<T, TAny>)
-        TAny(T&& v, std::pmr::memory_resource* provided_mr = std::pmr::get_default_resource()) :
+        TAny(T&& v, std::pmr::memory_resource* provided_mr = size_class_resource()) :
             m_mr(nullptr),
             m_vtable(nullptr),
             m_type(meta::type_hash_v<placeholder_t>),
@@ -305,7 +307,7 @@ namespace ers::impl {
             requires std::is_constructible_v<std::decay_t<T>, Args...>
         std::decay_t<T>* emplace(Args&&... args) {
             return emplace_with_resource<T>(
-                m_mr ? m_mr : std::pmr::get_default_resource(),
+                m_mr ? m_mr : size_class_resource(),
                 std::forward<Args>(args)...
             );
         }
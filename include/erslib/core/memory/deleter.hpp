@@ -1,25 +1,50 @@
 #pragma once
 
 // std
+#include <cstddef>
+#include <memory>
 #include <memory_resource>
+#include <type_traits>
 
 
 namespace ers::impl {
+    // Without a memory resource the object is assumed to come from plain "new".
+    // "size" and "align" describe the allocated object, which differs from "T" for polymorphic holders,
+    // sized resources (like "SizeClassResource") rely on them being exact.
     template<class T>
     struct deleter {
-        std::pmr::memory_resource* mr;
+        std::pmr::memory_resource* mr = nullptr;
+        size_t size = sizeof(T);
+        size_t align = alignof(T);
 
         deleter() = default;
         explicit deleter(std::pmr::memory_resource* mr) noexcept :
             mr(mr) {
         }
+        deleter(std::pmr::memory_resource* mr, size_t size, size_t align) noexcept :
+            mr(mr),
+            size(size),
+            align(align) {
+        }
 
         void operator()(T* ptr) {
             if (!ptr)
                 return;
 
+            if (!mr) {
+                delete ptr;
+                return;
+            }
+
+            // Derived object may start at another address than its base.
+            void* raw;
+            if constexpr (std::is_polymorphic_v<T>)
+                raw = dynamic_cast<void*>(ptr);
+            else
+                raw = ptr;
+
             std::destroy_at(ptr);
-            mr->deallocate(ptr, 1);
+            mr->deallocate(raw, size, align);
         }
     };
 }
@@ -0,0 +1,298 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// ers
+#include <erslib/core/concept/sbo.hpp>
+#include <erslib/core/memory/any.hpp>
+#include <erslib/core/memory/pool_resource.hpp>
+
+
+// Type-erased callable on the "TAny" storage: callables up to "Size" bytes are kept inline,
+// bigger ones go to "SizeClassResource". Unlike "std::function" the inline size is a parameter,
+// and the move-only flavour accepts non-copyable callables (e.g. ones owning a "holder_ptr").
+
+// Forward declaration
+
+namespace ers::impl {
+    template<typename Signature, size_t Size, bool Copyable>
+    class TFunction;
+}
+
+
+// Details
+
+namespace ers::impl {
+    template<size_t Size, typename R, typename... Args>
+    struct TFunctionVtable {
+        using storage_type = TAnyStorage<Size, alignof(std::max_align_t)>;
+
+
+        R (*invoke)(const storage_type& storage, Args&&... args);
+        void (*copy)(storage_type& dst, const storage_type& src);
+        void (*move)(storage_type& dst, storage_type& src) noexcept;
+        void (*destroy)(storage_type& storage) noexcept;
+
+
+        template<typename F>
+        static constexpr bool is_inline = is_sbo_applicable_v<F, Size, alignof(std::max_align_t)>;
+
+
+        // The callable is invoked as non-const, same as "std::function" does.
+        template<typename F>
+        static F* target(const storage_type& storage) {
+            auto& s = const_cast<storage_type&>(storage);
+
+            if constexpr (is_inline<F>)
+                return std::launder(reinterpret_cast<F*>(s.buffer));
+            else
+                return static_cast<F*>(s.heap);
+        }
+
+        template<typename F, typename... CtorArgs>
+        static void emplace(storage_type& storage, CtorArgs&&... ctor_args) {
+            if constexpr (is_inline<F>) {
+                std::construct_at(reinterpret_cast<F*>(storage.buffer), std::forward<CtorArgs>(ctor_args)...);
+            } else {
+                auto* mr = size_class_resource();
+                void* p = mr->allocate(sizeof(F), alignof(F));
+
+                try {
+                    storage.heap = std::construct_at(static_cast<F*>(p), std::forward<CtorArgs>(ctor_args)...);
+                } catch (...) {
+                    mr->deallocate(p, sizeof(F), alignof(F));
+                    throw;
+                }
+            }
+        }
+
+
+        template<typename F>
+        static R impl_invoke(const storage_type& storage, Args&&... args) {
+            return std::invoke(*target<F>(storage), std::forward<Args>(args)...);
+        }
+
+        template<typename F>
+        static void impl_copy(storage_type& dst, const storage_type& src) {
+            emplace<F>(dst, *target<F>(src));
+        }
+
+        // Heap callables just hand the pointer over.
+        template<typename F>
+        static void impl_move(storage_type& dst, storage_type& src) noexcept {
+            if constexpr (is_inline<F>) {
+                std::construct_at(reinterpret_cast<F*>(dst.buffer), std::move(*target<F>(src)));
+                std::destroy_at(target<F>(src));
+            } else {
+                dst.heap = src.heap;
+                src.heap = nullptr;
+            }
+        }
+
+        template<typename F>
+        static void impl_destroy(storage_type& storage) noexcept {
+            if constexpr (is_inline<F>) {
+                std::destroy_at(target<F>(storage));
+            } else if (storage.heap) {
+                std::destroy_at(target<F>(storage));
+                size_class_resource()->deallocate(storage.heap, sizeof(F), alignof(F));
+            }
+        }
+
+
+        template<typename F, bool Copyable>
+        static constexpr TFunctionVtable make() {
+            TFunctionVtable vtable;
+
+            vtable.invoke = &impl_invoke<F>;
+
+            if constexpr (Copyable)
+                vtable.copy = &impl_copy<F>;
+            else
+                vtable.copy = nullptr;
+
+            vtable.move = &impl_move<F>;
+            vtable.destroy = &impl_destroy<F>;
+
+            return vtable;
+        }
+
+        template<typename F, bool Copyable>
+        static constexpr const auto& get() {
+            static constexpr auto instance = make<F, Copyable>();
+            return instance;
+        }
+    };
+}
+
+
+// Implementation
+
+namespace ers::impl {
+    template<typename R, typename... Args, size_t Size, bool Copyable>
+    class TFunction<R(Args...), Size, Copyable> {
+        using vtable_type = TFunctionVtable<Size, R, Args...>;
+        using storage_type = vtable_type::storage_type;
+
+
+        // Kept apart, so constraints check "is_other" first and never ask whether an incomplete
+        // "TFunction" is invocable or copyable (e.g. while a class holding one checks its own copy).
+        template<typename F>
+        static constexpr bool is_invocable = std::is_invocable_r_v<R, std::decay_t<F>&, Args...>
+            && (!Copyable || std::is_copy_constructible_v<std::decay_t<F>>);
+
+        template<typename F>
+        static constexpr bool is_other = !std::is_same_v<std::remove_cvref_t<F>, TFunction>;
+
+
+    public:
+        using result_type = R;
+
+        static constexpr size_t inline_size = Size;
+
+
+        // Constructor
+
+        TFunction() noexcept = default;
+        TFunction(std::nullptr_t) noexcept {}
+
+        template<typename F>
+            requires is_other<F> && is_invocable<F>
+        TFunction(F&& f) {
+            using U = std::decay_t<F>;
+
+            if constexpr (std::is_pointer_v<U> || std::is_member_pointer_v<U>) {
+                if (!f)
+                    return;
+            }
+
+            vtable_type::template emplace<U>(m_storage, std::forward<F>(f));
+            m_vtable = &vtable_type::template get<U, Copyable>();
+        }
+
+        template<typename F, typename... CtorArgs>
+            requires is_other<F> && is_invocable<F>
+        explicit TFunction(std::in_place_type_t<F>, CtorArgs&&... ctor_args) {
+            vtable_type::template emplace<F>(m_storage, std::forward<CtorArgs>(ctor_args)...);
+            m_vtable = &vtable_type::template get<F, Copyable>();
+        }
+
+
+        // Copy
+
+        TFunction(const TFunction& other) requires Copyable {
+            if (other.m_vtable) {
+                other.m_vtable->copy(m_storage, other.m_storage);
+                m_vtable = other.m_vtable;
+            }
+        }
+        TFunction& operator=(const TFunction& other) requires Copyable {
+            if (this != &other)
+                TFunction(other).swap(*this);
+
+            return *this;
+        }
+
+
+        // Move
+
+        TFunction(TFunction&& other) noexcept {
+            if (other.m_vtable) {
+                other.m_vtable->move(m_storage, other.m_storage);
+                m_vtable = std::exchange(other.m_vtable, nullptr);
+            }
+        }
+        TFunction& operator=(TFunction&& other) noexcept {
+            if (this != &other) {
+                reset();
+
+                if (other.m_vtable) {
+                    other.m_vtable->move(m_storage, other.m_storage);
+                    m_vtable = std::exchange(other.m_vtable, nullptr);
+                }
+            }
+
+            return *this;
+        }
+
+        template<typename F>
+            requires is_other<F> && is_invocable<F>
+        TFunction& operator=(F&& f) {
+            TFunction(std::forward<F>(f)).swap(*this);
+            return *this;
+        }
+
+        TFunction& operator=(std::nullptr_t) noexcept {
+            reset();
+            return *this;
+        }
+
+
+        // Destructor
+
+        ~TFunction() {
+            reset();
+        }
+
+
+        // Modifiers
+
+        void reset() noexcept {
+            if (m_vtable) {
+                m_vtable->destroy(m_storage);
+                m_vtable = nullptr;
+            }
+        }
+
+        void swap(TFunction& other) noexcept {
+            TFunction tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+
+        // Observers
+
+        [[nodiscard]]
+        explicit operator bool() const noexcept { return m_vtable != nullptr; }
+
+        [[nodiscard]]
+        friend bool operator==(const TFunction& f, std::nullptr_t) noexcept { return !f; }
+
+
+        // Invocation
+
+        R operator()(Args... args) const {
+            if (!m_vtable)
+                throw std::bad_function_call();
+
+            return m_vtable->invoke(m_storage, std::forward<Args>(args)...);
+        }
+
+
+    protected:
+        const vtable_type* m_vtable = nullptr;
+        storage_type m_storage { .heap = nullptr };
+    };
+
+
+    template<typename Signature, size_t Size = 32>
+    using function = TFunction<Signature, Size, true>;
+
+    template<typename Signature, size_t Size = 32>
+    using move_only_function = TFunction<Signature, Size, false>;
+}
+
+
+// Exports
+
+namespace ers {
+    using impl::TFunction;
+    using impl::function;
+    using impl::move_only_function;
+}
@@ -7,6 +7,7 @@
 // ers
 #include <erslib/core/concept/util.hpp>
 #include <erslib/core/memory/deleter.hpp>
+#include <erslib/core/memory/pool_resource.hpp>
 
 
 namespace ers::impl {
@@ -53,6 +54,19 @@ namespace ers::impl {
         }
 
 
-        return holder_ptr<T>(static_cast<T*>(p), deleter<T>(mr));
+        return holder_ptr<T>(static_cast<T*>(p), deleter<T>(mr, sizeof(Derived), alignof(Derived)));
+    }
+
+
+    // Same as above, but on the process-wide "SizeClassResource".
+    template<typename T, typename... Args>
+    holder_ptr<T> make_pooled_holder(Args&&... args) {
+        return make_holder<T>(size_class_resource(), std::forward<Args>(args)...);
+    }
+
+    template<typename T, typename Derived, typename... Args>
+        requires std::derived_from<Derived, T>
+    holder_ptr<T> make_pooled_polymorphic_holder(Args&&... args) {
+        return make_polymorphic_holder<T, Derived>(size_class_resource(), std::forward<Args>(args)...);
     }
 }
@@ -0,0 +1,60 @@
+#pragma once
+
+// std
+#include <filesystem>
+#include <string_view>
+
+// export
+#include <erslib/export.hpp>
+
+
+namespace fs = std::filesystem;
+
+namespace ers::impl {
+    // Read-only mapping of a whole file, empty files aren't mapped at all.
+    class ERSLIB_EXPORT MappedFile {
+    public:
+        // Constructor
+
+        MappedFile() = default;
+        explicit MappedFile(const fs::path& path);
+
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+
+        // Destructor
+
+        ~MappedFile();
+
+
+        // Observers
+
+        [[nodiscard]]
+        const char* data() const noexcept { return m_data; }
+
+        [[nodiscard]]
+        size_t size() const noexcept { return m_size; }
+
+        [[nodiscard]]
+        bool empty() const noexcept { return m_size == 0; }
+
+        [[nodiscard]]
+        std::string_view view() const noexcept { return { m_data, m_size }; }
+
+
+    private:
+        void _unmap() noexcept;
+
+
+        const char* m_data = nullptr;
+        size_t m_size = 0;
+    };
+}
+
+
+// Exports
+
+namespace ers {
+    using impl::MappedFile;
+}
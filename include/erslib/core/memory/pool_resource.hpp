@@ -0,0 +1,94 @@
+#pragma once
+
+// std
+#include <array>
+#include <cstddef>
+#include <memory_resource>
+
+// export
+#include <erslib/export.hpp>
+
+
+// Size-class pool for small type-erased objects ("TAny" heap fallback, holders).
+//
+// Requests up to 256 bytes are rounded up to a 64/128/256-byte bin and served from a thread-local
+// free list, so the hot path is a pointer pop without locks. Blocks are carved from slabs taken from
+// the upstream resource and are never returned to it, a thread's surplus goes to a shared list instead.
+// Bigger or over-aligned requests go straight to the upstream resource.
+
+namespace ers::impl {
+    class ERSLIB_EXPORT SizeClassResource final : public std::pmr::memory_resource {
+    public:
+        static constexpr std::array<size_t, 3> bin_sizes = { 64, 128, 256 };
+        static constexpr size_t max_block_size = bin_sizes.back();
+        static constexpr size_t block_align = 64;
+        static constexpr size_t blocks_per_slab = 64;
+
+
+        // Process-wide instance, free lists are per-thread but shared by every user of the resource.
+        static SizeClassResource& instance();
+
+
+        SizeClassResource(const SizeClassResource&) = delete;
+        SizeClassResource& operator=(const SizeClassResource&) = delete;
+
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+
+    private:
+        explicit SizeClassResource(std::pmr::memory_resource* upstream);
+
+
+        std::pmr::memory_resource* m_upstream;
+    };
+
+
+    inline std::pmr::memory_resource* size_class_resource() {
+        return &SizeClassResource::instance();
+    }
+
+
+    // Stateless allocator over "SizeClassResource", for allocator-aware owners of small objects
+    // ("std::polymorphic", node-based containers). Being stateless, copies of the owner stay in the pool
+    // and take no extra space.
+    template<typename T>
+    struct pool_allocator {
+        using value_type = T;
+
+
+        pool_allocator() noexcept = default;
+
+        template<typename U>
+        pool_allocator(const pool_allocator<U>&) noexcept {}
+
+
+        [[nodiscard]]
+        T* allocate(size_t n) {
+            return static_cast<T*>(size_class_resource()->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T* p, size_t n) noexcept {
+            size_class_resource()->deallocate(p, n * sizeof(T), alignof(T));
+        }
+
+
+        template<typename U>
+        friend bool operator==(const pool_allocator&, const pool_allocator<U>&) noexcept { return true; }
+    };
+}
+
+
+// Exports
+
+namespace ers {
+    using impl::SizeClassResource;
+    using impl::size_class_resource;
+    using impl::pool_allocator;
+}
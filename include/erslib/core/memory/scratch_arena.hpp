@@ -0,0 +1,123 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+// export
+#include <erslib/export.hpp>
+
+
+// Per-thread bump allocator for short-lived temporaries (per request, per frame, per call).
+//
+// Allocation is a pointer bump, deallocation does nothing: memory comes back only when a checkpoint
+// goes out of scope, and then everything allocated after it is released at once. Blocks are kept
+// for the next scope, so a warmed-up arena doesn't touch the heap at all.
+//
+//     auto scope = ers::ScratchArena::local().checkpoint();
+//     std::pmr::vector<int> temp(&ers::ScratchArena::local());
+//
+// Containers living on the arena must die before their checkpoint does.
+
+namespace ers::impl {
+    class ERSLIB_EXPORT ScratchArena final : public std::pmr::memory_resource {
+    public:
+        static constexpr size_t initial_block_size = 64 * 1024;
+
+
+        // Rewinds the arena to the state it had when the checkpoint was made.
+        class Checkpoint {
+            friend ScratchArena;
+
+
+        public:
+            Checkpoint(const Checkpoint&) = delete;
+            Checkpoint& operator=(const Checkpoint&) = delete;
+
+            ~Checkpoint() {
+                m_arena->_rewind(m_block, m_offset);
+            }
+
+
+        private:
+            Checkpoint(ScratchArena& arena, size_t block, size_t offset) :
+                m_arena(&arena),
+                m_block(block),
+                m_offset(offset) {
+            }
+
+
+            ScratchArena* m_arena;
+            size_t m_block;
+            size_t m_offset;
+        };
+
+
+        // Constructor
+
+        explicit ScratchArena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+        ScratchArena(const ScratchArena&) = delete;
+        ScratchArena& operator=(const ScratchArena&) = delete;
+
+
+        // Destructor
+
+        ~ScratchArena() override;
+
+
+        // Arena of the calling thread.
+        static ScratchArena& local();
+
+
+        // Scopes
+
+        [[nodiscard]]
+        Checkpoint checkpoint() noexcept {
+            return Checkpoint(*this, m_block, m_offset);
+        }
+
+
+        // Observers
+
+        // Bytes handed out since the arena was empty, including alignment padding.
+        [[nodiscard]]
+        size_t used() const noexcept;
+
+        [[nodiscard]]
+        size_t capacity() const noexcept;
+
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+
+    private:
+        struct block_t {
+            std::byte* data;
+            size_t size;
+        };
+
+
+        std::pmr::memory_resource* m_upstream;
+        std::vector<block_t> m_blocks;
+        size_t m_block = 0;
+        size_t m_offset = 0;
+
+
+        void _rewind(size_t block, size_t offset) noexcept;
+    };
+}
+
+
+// Exports
+
+namespace ers {
+    using impl::ScratchArena;
+}
@@ -4,10 +4,20 @@
 // Includes
 
 #include <erslib/core/thread_safe/map.hpp>
+#include <erslib/core/thread_safe/pinned.hpp>
+#include <erslib/core/thread_safe/sharded_map.hpp>
+#include <erslib/core/thread_safe/snapshot_map.hpp>
+#include <erslib/core/thread_safe/worker_pool.hpp>
 
 
 // Exports
 
 namespace ers::thread_safe {
     using impl::thread_safe::Map;
+    using impl::thread_safe::Pinned;
+    using impl::thread_safe::ShardedMap;
+    using impl::thread_safe::SnapshotMap;
+
+    using impl::thread_safe::TaskPriority;
+    using impl::thread_safe::WorkerPool;
 }
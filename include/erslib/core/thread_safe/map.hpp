@@ -1,11 +1,19 @@
 #pragma once
 
 // std
+#include <format>
 #include <mutex>
+#include <ranges>
 #include <shared_mutex>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 
 // ers
 #include <erslib/core/concept/container.hpp>
+#include <erslib/core/concept/pair.hpp>
+#include <erslib/core/exception/logic_error.hpp>
+#include <erslib/core/thread_safe/pinned.hpp>
 #include <erslib/core/type/optional.hpp>
 
 
@@ -22,6 +30,8 @@ namespace ers::impl::thread_safe {
         using iterator = container_type::iterator;
         using const_iterator = container_type::const_iterator;
 
+        using pinned_type = Pinned<mapped_type>;
+
 
         // Constructor
 
@@ -65,6 +75,11 @@ namespace ers::impl::thread_safe {
             return m_data.size();
         }
 
+        void reserve(size_t n) requires requires(container_type& c, size_t count) { c.reserve(count); } {
+            std::unique_lock lock(this->m_mutex);
+            m_data.reserve(n);
+        }
+
 
         // I/O
 
@@ -74,6 +89,8 @@ namespace ers::impl::thread_safe {
             auto [_, flag] = this->m_data.emplace(k, std::move(v));
             return flag;
         }
+        // The reference outlives the lock, so it's only safe while nobody inserts concurrently,
+        // otherwise use "get_copy", "visit" or "pin".
         template<typename T>
         [[nodiscard]]
         optional<const mapped_type&> get(const T& k) const {
@@ -86,17 +103,109 @@ namespace ers::impl::thread_safe {
             return it->second;
         }
 
+        template<typename T>
+        [[nodiscard]]
+        optional<mapped_type> get_copy(const T& k) const {
+            std::shared_lock lock(this->m_mutex);
+            auto it = this->m_data.find(k);
+
+            if (it == this->m_data.end())
+                return nullopt;
+
+            return it->second;
+        }
+
+
+        // Batched I/O
+
+        // "items" is a range of key-value pairs, existing keys keep their values.
+        // Takes the lock once for the whole batch, returns amount of inserted items.
+        template<std::ranges::input_range R>
+            requires PairLike<std::ranges::range_value_t<R>>
+        size_t set_many(R&& items) {
+            std::unique_lock lock(this->m_mutex);
+
+            if constexpr (std::ranges::sized_range<R> && requires { this->m_data.reserve(size_t()); })
+                this->m_data.reserve(this->m_data.size() + std::ranges::size(items));
+
+            size_t inserted = 0;
+            for (auto&& item : items) {
+                if constexpr (std::is_rvalue_reference_v<R&&>)
+                    inserted += this->m_data.emplace(std::move(item.first), std::move(item.second)).second;
+                else
+                    inserted += this->m_data.emplace(item.first, item.second).second;
+            }
+
+            return inserted;
+        }
+
+        // Writes a copy of every found value (or nullopt) into "out", returns amount of found keys.
+        template<std::ranges::input_range R, typename OutIt>
+        size_t get_many(R&& keys, OutIt out) const {
+            std::shared_lock lock(this->m_mutex);
+
+            size_t found = 0;
+            for (const auto& k : keys) {
+                auto it = this->m_data.find(k);
+
+                if (it == this->m_data.end()) {
+                    *out++ = optional<mapped_type>(nullopt);
+                } else {
+                    *out++ = optional<mapped_type>(it->second);
+                    found++;
+                }
+            }
+
+            return found;
+        }
+
 
         // Lookup
 
+        // Same caveat as for "get", throws if there is no such key.
         template<typename T>
         [[nodiscard]]
         const mapped_type& operator[](const T& k) const {
             std::shared_lock lock(this->m_mutex);
             auto it = this->m_data.find(k);
+
+            if (it == this->m_data.end()) {
+                // Keys of any type may be looked up, only those std::format knows are named.
+                if constexpr (std::formattable<T, char>)
+                    throw make_out_of_range_error("Accessing non-existent key '{}' in ers::thread_safe::Map", k);
+                else
+                    throw make_out_of_range_error(std::string_view("Accessing non-existent key in ers::thread_safe::Map"));
+            }
+
             return it->second;
         }
 
+        // Calls "fn(const mapped_type&)" under the shared lock, returns false if there is no such key.
+        template<typename T, typename Fn>
+        bool visit(const T& k, Fn&& fn) const {
+            std::shared_lock lock(this->m_mutex);
+            auto it = this->m_data.find(k);
+
+            if (it == this->m_data.end())
+                return false;
+
+            std::forward<Fn>(fn)(it->second);
+            return true;
+        }
+
+        // Empty handle if there is no such key, otherwise it keeps the shared lock until released.
+        template<typename T>
+        [[nodiscard]]
+        pinned_type pin(const T& k) const {
+            std::shared_lock lock(this->m_mutex);
+            auto it = this->m_data.find(k);
+
+            if (it == this->m_data.end())
+                return pinned_type();
+
+            return pinned_type(std::move(lock), &it->second);
+        }
+
         [[nodiscard]]
         const container_type& wrapped_data() const {
             return this->m_data;
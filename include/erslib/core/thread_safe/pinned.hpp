@@ -0,0 +1,60 @@
+#pragma once
+
+// std
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+
+
+namespace ers::impl::thread_safe {
+    // Borrowed reference into a locked container: keeps the shared lock while alive,
+    // so writers (and rehashes) wait until it is released. Keep its lifetime short.
+    template<typename V>
+    class Pinned {
+    public:
+        using value_type = V;
+
+
+        // Constructor
+
+        Pinned() = default;
+
+        Pinned(std::shared_lock<std::shared_mutex> lock, const V* value) :
+            m_lock(std::move(lock)),
+            m_value(value) {
+        }
+
+        Pinned(Pinned&&) noexcept = default;
+        Pinned& operator=(Pinned&&) noexcept = default;
+
+
+        // Observers
+
+        [[nodiscard]]
+        explicit operator bool() const noexcept { return m_value != nullptr; }
+
+        [[nodiscard]]
+        const V& operator*() const noexcept { return *m_value; }
+
+        [[nodiscard]]
+        const V* operator->() const noexcept { return m_value; }
+
+        [[nodiscard]]
+        const V* get() const noexcept { return m_value; }
+
+
+        // Modifiers
+
+        void reset() noexcept {
+            m_value = nullptr;
+
+            if (m_lock.owns_lock())
+                m_lock.unlock();
+        }
+
+
+    private:
+        std::shared_lock<std::shared_mutex> m_lock;
+        const V* m_value = nullptr;
+    };
+}
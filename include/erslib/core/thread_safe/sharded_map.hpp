@@ -0,0 +1,338 @@
+#pragma once
+
+// std
+#include <array>
+#include <bit>
+#include <format>
+#include <mutex>
+#include <ranges>
+#include <shared_mutex>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// ers
+#include <erslib/core/concept/container.hpp>
+#include <erslib/core/concept/pair.hpp>
+#include <erslib/core/exception/logic_error.hpp>
+#include <erslib/core/thread_safe/pinned.hpp>
+#include <erslib/core/type/optional.hpp>
+
+
+// Lock-striped variant of "thread_safe::Map": keys are spread over "Shards" independent containers,
+// each guarded by its own mutex, so writers block only the readers of one shard.
+// The shard is picked from the key hash with a multiplicative mix, so identity hashes spread too.
+
+namespace ers::impl::thread_safe {
+    template<typename Container, size_t Shards = 16>
+        requires HashMapConcept<Container> && (std::has_single_bit(Shards))
+    class ShardedMap {
+    public:
+        using container_type = Container;
+        using key_type = container_type::key_type;
+        using mapped_type = container_type::mapped_type;
+        using value_type = container_type::value_type;
+        using hasher = container_type::hasher;
+
+        using iterator = container_type::iterator;
+        using const_iterator = container_type::const_iterator;
+
+        using pinned_type = Pinned<mapped_type>;
+
+
+        static constexpr size_t shard_count = Shards;
+
+
+        // Constructor
+
+        ShardedMap() = default;
+
+        ShardedMap(const ShardedMap& another) {
+            for (size_t i = 0; i < Shards; i++) {
+                std::shared_lock lock(another.m_shards[i].mutex);
+                m_shards[i].data = another.m_shards[i].data;
+            }
+        }
+        ShardedMap& operator=(const ShardedMap& another) {
+            if (this == &another)
+                return *this;
+
+            for (size_t i = 0; i < Shards; i++) {
+                std::unique_lock lock(m_shards[i].mutex, std::defer_lock);
+                std::shared_lock another_lock(another.m_shards[i].mutex, std::defer_lock);
+                std::lock(lock, another_lock);
+
+                m_shards[i].data = another.m_shards[i].data;
+            }
+
+            return *this;
+        }
+
+        ShardedMap(ShardedMap&& another) noexcept {
+            for (size_t i = 0; i < Shards; i++)
+                m_shards[i].data = std::move(another.m_shards[i].data);
+        }
+        ShardedMap& operator=(ShardedMap&& another) noexcept {
+            for (size_t i = 0; i < Shards; i++) {
+                std::unique_lock lock(m_shards[i].mutex);
+                m_shards[i].data = std::move(another.m_shards[i].data);
+            }
+
+            return *this;
+        }
+
+
+        // Destructor
+
+        ~ShardedMap() = default;
+
+
+        // Capacity
+
+        // Shards are visited one by one, so under concurrent writes the result is only approximate.
+        [[nodiscard]]
+        bool empty() const {
+            for (const auto& shard : m_shards) {
+                std::shared_lock lock(shard.mutex);
+
+                if (!shard.data.empty())
+                    return false;
+            }
+
+            return true;
+        }
+
+        // Same as above.
+        [[nodiscard]]
+        size_t size() const {
+            size_t result = 0;
+
+            for (const auto& shard : m_shards) {
+                std::shared_lock lock(shard.mutex);
+                result += shard.data.size();
+            }
+
+            return result;
+        }
+
+        // Reserves an even share of "n" in every shard.
+        void reserve(size_t n) requires requires(container_type& c, size_t count) { c.reserve(count); } {
+            for (auto& shard : m_shards) {
+                std::unique_lock lock(shard.mutex);
+                shard.data.reserve((n + Shards - 1) / Shards);
+            }
+        }
+
+
+        // I/O
+
+        template<typename T>
+        bool set(const T& k, mapped_type v = mapped_type()) {
+            auto& shard = _shard_of(k);
+
+            std::unique_lock lock(shard.mutex);
+            auto [_, flag] = shard.data.emplace(k, std::move(v));
+            return flag;
+        }
+
+        template<typename T>
+        bool erase(const T& k) {
+            auto& shard = _shard_of(k);
+
+            std::unique_lock lock(shard.mutex);
+            return shard.data.erase(k) != 0;
+        }
+
+        void clear() {
+            for (auto& shard : m_shards) {
+                std::unique_lock lock(shard.mutex);
+                shard.data.clear();
+            }
+        }
+
+        // Same caveats as "thread_safe::Map::get".
+        template<typename T>
+        [[nodiscard]]
+        optional<const mapped_type&> get(const T& k) const {
+            const auto& shard = _shard_of(k);
+
+            std::shared_lock lock(shard.mutex);
+            auto it = shard.data.find(k);
+
+            if (it == shard.data.end())
+                return nullopt;
+
+            return it->second;
+        }
+
+        template<typename T>
+        [[nodiscard]]
+        optional<mapped_type> get_copy(const T& k) const {
+            const auto& shard = _shard_of(k);
+
+            std::shared_lock lock(shard.mutex);
+            auto it = shard.data.find(k);
+
+            if (it == shard.data.end())
+                return nullopt;
+
+            return it->second;
+        }
+
+
+        // Batched I/O
+
+        // Items are grouped by shard first, so every shard is locked at most once per call.
+        template<std::ranges::random_access_range R>
+            requires PairLike<std::ranges::range_value_t<R>>
+        size_t set_many(R&& items) {
+            const auto groups = _group_by_shard(items, [](const auto& item) -> const auto& { return item.first; });
+
+            size_t inserted = 0;
+            for (size_t s = 0; s < Shards; s++) {
+                if (groups[s].empty())
+                    continue;
+
+                auto& shard = m_shards[s];
+                std::unique_lock lock(shard.mutex);
+
+                for (size_t i : groups[s]) {
+                    auto&& item = std::ranges::begin(items)[i];
+
+                    if constexpr (std::is_rvalue_reference_v<R&&>)
+                        inserted += shard.data.emplace(std::move(item.first), std::move(item.second)).second;
+                    else
+                        inserted += shard.data.emplace(item.first, item.second).second;
+                }
+            }
+
+            return inserted;
+        }
+
+        // Unlike "thread_safe::Map::get_many", "out" is random access: results land in the order of "keys".
+        template<std::ranges::random_access_range R, std::random_access_iterator OutIt>
+        size_t get_many(R&& keys, OutIt out) const {
+            const auto groups = _group_by_shard(keys, [](const auto& k) -> const auto& { return k; });
+
+            size_t found = 0;
+            for (size_t s = 0; s < Shards; s++) {
+                if (groups[s].empty())
+                    continue;
+
+                const auto& shard = m_shards[s];
+                std::shared_lock lock(shard.mutex);
+
+                for (size_t i : groups[s]) {
+                    auto it = shard.data.find(std::ranges::begin(keys)[i]);
+
+                    if (it == shard.data.end()) {
+                        out[i] = optional<mapped_type>(nullopt);
+                    } else {
+                        out[i] = optional<mapped_type>(it->second);
+                        found++;
+                    }
+                }
+            }
+
+            return found;
+        }
+
+
+        // Lookup
+
+        template<typename T>
+        [[nodiscard]]
+        const mapped_type& operator[](const T& k) const {
+            const auto& shard = _shard_of(k);
+
+            std::shared_lock lock(shard.mutex);
+            auto it = shard.data.find(k);
+
+            if (it == shard.data.end()) {
+                if constexpr (std::formattable<T, char>)
+                    throw make_out_of_range_error("Accessing non-existent key '{}' in ers::thread_safe::ShardedMap", k);
+                else
+                    throw make_out_of_range_error(std::string_view("Accessing non-existent key in ers::thread_safe::ShardedMap"));
+            }
+
+            return it->second;
+        }
+
+        // Locks only the shard of "k".
+        template<typename T, typename Fn>
+        bool visit(const T& k, Fn&& fn) const {
+            const auto& shard = _shard_of(k);
+
+            std::shared_lock lock(shard.mutex);
+            auto it = shard.data.find(k);
+
+            if (it == shard.data.end())
+                return false;
+
+            std::forward<Fn>(fn)(it->second);
+            return true;
+        }
+
+        template<typename T>
+        [[nodiscard]]
+        pinned_type pin(const T& k) const {
+            const auto& shard = _shard_of(k);
+
+            std::shared_lock lock(shard.mutex);
+            auto it = shard.data.find(k);
+
+            if (it == shard.data.end())
+                return pinned_type();
+
+            return pinned_type(std::move(lock), &it->second);
+        }
+
+        // Not synchronized, meant for single-threaded phases (e.g. startup or shutdown).
+        [[nodiscard]]
+        const container_type& wrapped_shard(size_t index) const {
+            return m_shards[index].data;
+        }
+
+
+    protected:
+        // Each shard sits on its own cache line, so neighbouring mutexes don't false-share.
+        struct alignas(64) shard_t {
+            mutable std::shared_mutex mutex;
+            container_type data;
+        };
+
+
+        std::array<shard_t, Shards> m_shards;
+        [[no_unique_address]] hasher m_hasher;
+
+
+        template<typename T>
+        size_t _shard_index(const T& k) const {
+            if constexpr (Shards == 1)
+                return 0;
+            else
+                return (m_hasher(k) * 0x9e3779b97f4a7c15ull) >> (64 - std::countr_zero(Shards));
+        }
+
+        template<typename R, typename KeyFn>
+        std::array<std::vector<size_t>, Shards> _group_by_shard(const R& range, KeyFn&& key_of) const {
+            std::array<std::vector<size_t>, Shards> result;
+
+            const size_t n = std::ranges::size(range);
+            for (size_t i = 0; i < n; i++)
+                result[_shard_index(key_of(std::ranges::begin(range)[i]))].push_back(i);
+
+            return result;
+        }
+
+        template<typename T>
+        shard_t& _shard_of(const T& k) {
+            return m_shards[_shard_index(k)];
+        }
+        template<typename T>
+        const shard_t& _shard_of(const T& k) const {
+            return m_shards[_shard_index(k)];
+        }
+    };
+}
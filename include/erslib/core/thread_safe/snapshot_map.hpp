@@ -0,0 +1,164 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <mutex>
+#include <utility>
+
+// ers
+#include <erslib/core/concept/container.hpp>
+#include <erslib/core/memory/shared_ptr.hpp>
+#include <erslib/core/type/general.hpp>
+
+
+// Read-copy-update map for read-mostly registries.
+//
+// Readers work with an immutable snapshot and never wait for writers, writers copy the current snapshot,
+// change the copy and publish it atomically. Old snapshots live as long as somebody still holds them.
+// Every write copies the whole container, so batch writes through "update" where possible.
+
+namespace ers::impl::thread_safe {
+    template<typename Container>
+        requires HashMapConcept<Container>
+    class SnapshotMap {
+    public:
+        using container_type = Container;
+        using key_type = container_type::key_type;
+        using mapped_type = container_type::mapped_type;
+        using value_type = container_type::value_type;
+
+        using snapshot_type = shared_ptr<const container_type>;
+        // Keeps its whole snapshot alive, so it stays valid after later writes.
+        using pinned_type = shared_ptr<const mapped_type>;
+
+
+        // Caches a snapshot and only reloads it when a writer published a newer one, so steady-state
+        // lookups touch just the shared version counter. One reader per thread, it isn't thread-safe itself.
+        class Reader {
+        public:
+            explicit Reader(const SnapshotMap& map) :
+                m_map(&map) {
+                refresh();
+            }
+
+
+            const container_type& refresh() {
+                if (const u64 version = m_map->version(); version != m_version || !m_snapshot) {
+                    m_snapshot = m_map->snapshot();
+                    m_version = version;
+                }
+
+                return *m_snapshot;
+            }
+
+            template<typename T>
+            [[nodiscard]]
+            const mapped_type* find(const T& k) {
+                const auto& data = refresh();
+                auto it = data.find(k);
+
+                return it != data.end() ? &it->second : nullptr;
+            }
+
+
+        private:
+            const SnapshotMap* m_map;
+            snapshot_type m_snapshot;
+            u64 m_version = 0;
+        };
+
+
+        // Constructor
+
+        SnapshotMap() :
+            m_snapshot(make_shared<const container_type>()) {
+        }
+
+        explicit SnapshotMap(container_type data) :
+            m_snapshot(make_shared<const container_type>(std::move(data))) {
+        }
+
+        SnapshotMap(const SnapshotMap&) = delete;
+        SnapshotMap& operator=(const SnapshotMap&) = delete;
+
+
+        // Destructor
+
+        ~SnapshotMap() = default;
+
+
+        // Capacity
+
+        [[nodiscard]]
+        bool empty() const { return snapshot()->empty(); }
+
+        [[nodiscard]]
+        size_t size() const { return snapshot()->size(); }
+
+
+        // I/O
+
+        template<typename T>
+        bool set(const T& k, mapped_type v = mapped_type()) {
+            bool flag = false;
+
+            update([&](container_type& data) {
+                flag = data.emplace(k, std::move(v)).second;
+            });
+
+            return flag;
+        }
+
+        template<typename T>
+        [[nodiscard]]
+        pinned_type get(const T& k) const {
+            auto current = snapshot();
+            auto it = current->find(k);
+
+            if (it == current->end())
+                return nullptr;
+
+            return pinned_type(std::move(current), &it->second);
+        }
+
+
+        // Snapshots
+
+        [[nodiscard]]
+        snapshot_type snapshot() const {
+            return m_snapshot.load(std::memory_order_acquire);
+        }
+
+        // Grows by one with every published snapshot.
+        [[nodiscard]]
+        u64 version() const {
+            return m_version.load(std::memory_order_acquire);
+        }
+
+        [[nodiscard]]
+        Reader reader() const {
+            return Reader(*this);
+        }
+
+
+        // Modifiers
+
+        // Calls "fn(container_type&)" on a private copy and publishes it, writers are serialized.
+        template<typename Fn>
+        void update(Fn&& fn) {
+            std::unique_lock lock(m_writer_mutex);
+
+            auto next = make_shared<container_type>(*m_snapshot.load(std::memory_order_relaxed));
+            std::forward<Fn>(fn)(*next);
+
+            m_snapshot.store(std::move(next), std::memory_order_release);
+            m_version.fetch_add(1, std::memory_order_release);
+        }
+
+
+    protected:
+        atomic_shared_ptr<const container_type> m_snapshot;
+        std::atomic<u64> m_version = 1;
+        std::mutex m_writer_mutex;
+    };
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+// std
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stop_token>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// ers
+#include <erslib/core/memory/function.hpp>
+#include <erslib/core/type/general.hpp>
+
+// export
+#include <erslib/export.hpp>
+
+
+// Fixed set of worker threads fed from one priority queue.
+//
+// Tasks of the same priority run in submission order. Each task gets its own stop token, so a task
+// cancelled while still queued can tell it and finish without doing its work. On destruction the
+// remaining tasks are cancelled and drained, nothing is silently dropped.
+
+namespace ers::impl::thread_safe {
+    enum class TaskPriority : u8 {
+        Low = 0,
+        Normal,
+        High
+    };
+
+
+    class ERSLIB_EXPORT WorkerPool {
+    public:
+        // Must not throw, report failures through whatever the task was created with.
+        using task_fn = move_only_function<void(std::stop_token), 48>;
+
+
+        // Constructor
+
+        explicit WorkerPool(size_t threads = default_threads());
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+
+        // Destructor
+
+        ~WorkerPool();
+
+
+        // Modifiers
+
+        // Returns the source that cancels the task.
+        std::stop_source post(task_fn fn, TaskPriority priority = TaskPriority::Normal);
+
+        // Runs "fn" even if the pool is being destroyed, its result or exception goes to the future.
+        template<typename Fn>
+            requires std::invocable<Fn>
+        auto submit(Fn&& fn, TaskPriority priority = TaskPriority::Normal) -> std::future<std::invoke_result_t<Fn>> {
+            std::packaged_task<std::invoke_result_t<Fn>()> task(std::forward<Fn>(fn));
+            auto future = task.get_future();
+
+            post([task = std::move(task)](std::stop_token) mutable { task(); }, priority);
+
+            return future;
+        }
+
+        // Blocks until the queue is empty and no task is running.
+        void wait_idle();
+
+
+        // Observers
+
+        [[nodiscard]]
+        size_t size() const noexcept { return m_workers.size(); }
+
+        [[nodiscard]]
+        static size_t default_threads() noexcept;
+
+
+    private:
+        struct task_t {
+            TaskPriority priority;
+            u64 sequence;
+            std::stop_source stop { std::nostopstate };
+            task_fn fn;
+        };
+
+
+        void _run(std::stop_token stop);
+
+        static bool _before(const task_t& lhs, const task_t& rhs) noexcept;
+
+
+        std::mutex m_mutex;
+        std::condition_variable_any m_ready;
+        std::condition_variable m_idle;
+        std::vector<task_t> m_queue;
+        u64 m_sequence = 0;
+        size_t m_active = 0;
+
+        // Last, so workers are joined before the queue goes away.
+        std::vector<std::jthread> m_workers;
+    };
+}
@@ -0,0 +1,222 @@
+#pragma once
+
+// std
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// ers
+#include <erslib/core/hashing/rapid.hpp>
+#include <erslib/core/type/general.hpp>
+
+
+// Immutable string-keyed map with a perfect hash built at compile time (hash and displace).
+//
+// The key hash picks a bucket. Buckets with one key point straight at its slot, bigger ones
+// store a displacement that is mixed into the key hash, chosen so that keys of all buckets land
+// in distinct slots. So lookup costs one string hash, one integer mix and one string comparison.
+
+namespace ers::impl {
+    template<typename V, size_t N, typename Hasher = RapidHash<std::string_view>>
+    class ConstStringMap {
+    public:
+        using key_type = std::string_view;
+        using mapped_type = V;
+        using value_type = std::pair<std::string_view, V>;
+
+        using const_iterator = const value_type*;
+
+
+        static constexpr size_t table_size = std::bit_ceil(N ? N : 1);
+
+
+        // Constructor
+
+        consteval explicit ConstStringMap(const std::array<value_type, N>& items) :
+            m_items(items) {
+            for (m_seed = 0; !_try_build(); m_seed++) {}
+        }
+
+
+        // Capacity
+
+        [[nodiscard]]
+        constexpr size_t size() const noexcept { return N; }
+
+        [[nodiscard]]
+        constexpr bool empty() const noexcept { return N == 0; }
+
+
+        // Lookup
+
+        [[nodiscard]]
+        constexpr const_iterator find(std::string_view key) const noexcept {
+            const size_t hash = Hasher {}(key, m_seed);
+            const i64 displacement = m_displacements[hash & mask];
+
+            if (displacement == 0)
+                return end();
+
+            const size_t slot = displacement < 0
+                ? static_cast<size_t>(-displacement - 1)
+                : _displace(hash, static_cast<size_t>(displacement));
+
+            const size_t index = m_slots[slot];
+
+            if (index == N || m_items[index].first != key)
+                return end();
+
+            return m_items.data() + index;
+        }
+
+        [[nodiscard]]
+        constexpr bool contains(std::string_view key) const noexcept {
+            return find(key) != end();
+        }
+
+        [[nodiscard]]
+        constexpr const V& at(std::string_view key) const {
+            auto it = find(key);
+
+            if (it == end())
+                throw std::out_of_range("ers::ConstStringMap: key not found");
+
+            return it->second;
+        }
+
+
+        // Iterators (in construction order)
+
+        [[nodiscard]]
+        constexpr const_iterator begin() const noexcept { return m_items.data(); }
+
+        [[nodiscard]]
+        constexpr const_iterator end() const noexcept { return m_items.data() + N; }
+
+
+    private:
+        static constexpr size_t mask = table_size - 1;
+        static constexpr size_t max_displacement = 1 << 16;
+
+
+        std::array<value_type, N> m_items;
+        std::array<i64, table_size> m_displacements = {};
+        std::array<size_t, table_size> m_slots = {};
+        size_t m_seed = 0;
+
+
+        static constexpr size_t _displace(size_t hash, size_t displacement) noexcept {
+            return hashing::rapid_mix(hash ^ hashing::rapid_secret[0], displacement ^ hashing::rapid_secret[1]) & mask;
+        }
+
+        // Builds the table for the current seed, returns false if it has to be retried with another one.
+        constexpr bool _try_build() {
+            std::vector<size_t> hashes(N);
+            std::vector<std::vector<size_t>> buckets(table_size);
+
+            for (size_t i = 0; i < N; i++) {
+                hashes[i] = Hasher {}(m_items[i].first, m_seed);
+                buckets[hashes[i] & mask].push_back(i);
+            }
+
+            std::vector<size_t> order(table_size);
+            for (size_t b = 0; b < table_size; b++)
+                order[b] = b;
+
+            std::ranges::sort(order, [&buckets](size_t lhs, size_t rhs) {
+                if (buckets[lhs].size() != buckets[rhs].size())
+                    return buckets[lhs].size() > buckets[rhs].size();
+                return lhs < rhs;
+            });
+
+
+            m_displacements.fill(0);
+            m_slots.fill(N);
+
+            std::vector<size_t> candidate;
+
+            for (size_t b : order) {
+                const auto& bucket = buckets[b];
+
+                if (bucket.size() <= 1)
+                    break;
+
+                // Equal keys always share a bucket, so it's enough to look for duplicates here.
+                for (size_t i = 0; i < bucket.size(); i++)
+                    for (size_t j = i + 1; j < bucket.size(); j++)
+                        if (m_items[bucket[i]].first == m_items[bucket[j]].first)
+                            throw std::logic_error("ers::ConstStringMap: duplicate key");
+
+                bool placed = false;
+                for (size_t d = 1; d < max_displacement && !placed; d++) {
+                    candidate.clear();
+                    placed = true;
+
+                    for (size_t i : bucket) {
+                        const size_t slot = _displace(hashes[i], d);
+
+                        if (m_slots[slot] != N || std::ranges::find(candidate, slot) != candidate.end()) {
+                            placed = false;
+                            break;
+                        }
+
+                        candidate.push_back(slot);
+                    }
+
+                    if (placed) {
+                        for (size_t k = 0; k < bucket.size(); k++)
+                            m_slots[candidate[k]] = bucket[k];
+
+                        m_displacements[b] = static_cast<i64>(d);
+                    }
+                }
+
+                if (!placed)
+                    return false;
+            }
+
+
+            // Single-key buckets take whatever slots are left.
+            size_t free_slot = 0;
+
+            for (size_t b : order) {
+                const auto& bucket = buckets[b];
+
+                if (bucket.size() != 1)
+                    continue;
+
+                while (m_slots[free_slot] != N)
+                    free_slot++;
+
+                m_slots[free_slot] = bucket.front();
+                m_displacements[b] = -static_cast<i64>(free_slot) - 1;
+            }
+
+
+            return true;
+        }
+    };
+
+
+    template<typename V, size_t N>
+    consteval auto make_const_string_map(const std::pair<std::string_view, V> (&items)[N]) {
+        std::array<std::pair<std::string_view, V>, N> result {};
+
+        for (size_t i = 0; i < N; i++)
+            result[i] = items[i];
+
+        return ConstStringMap<V, N>(result);
+    }
+}
+
+
+// Exports
+
+namespace ers {
+    using impl::ConstStringMap;
+    using impl::make_const_string_map;
+}
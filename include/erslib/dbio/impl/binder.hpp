@@ -1,16 +1,19 @@
 #pragma once
 
 // std
-#include <functional>
 #include <string>
 #include <type_traits>
 
 // pqxx
 #include <pqxx/params>
 
+// ers
+#include <erslib/core/memory/function.hpp>
+
 
 namespace dbio::impl {
-    using binder_t = std::function<void(pqxx::params&)>;
+    // Owned strings and byte buffers fit inline, so making a binder doesn't allocate.
+    using binder_t = ers::function<void(pqxx::params&), 40>;
 
     template<typename T>
     using owned_t = std::conditional_t<
@@ -4,6 +4,7 @@
 #include <memory>
 
 // ers
+#include <erslib/core/memory/pool_resource.hpp>
 #include <erslib/core/type/result.hpp>
 #include <erslib/dbio/impl/context.hpp>
 #include <erslib/dbio/impl/slot.hpp>
@@ -13,7 +14,9 @@
 
 
 namespace dbio::impl {
-    using Clause = std::polymorphic<class IClause>;
+    // Clauses are small and a query builder makes many of them, so they live in the size-class pool.
+    class IClause;
+    using Clause = std::polymorphic<IClause, ers::pool_allocator<IClause>>;
 
     class ERSLIB_EXPORT IClause {
     public:
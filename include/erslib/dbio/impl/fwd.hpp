@@ -3,9 +3,12 @@
 // std
 #include <memory>
 
+// ers
+#include <erslib/core/memory/pool_resource.hpp>
+
 
 namespace dbio::impl {
     class IClause;
 
-    using Clause = std::polymorphic<IClause>;
+    using Clause = std::polymorphic<IClause, ers::pool_allocator<IClause>>;
 }
@@ -27,7 +27,7 @@ namespace dbio::impl {
         Arity arity;
 
         constexpr u64 id() const noexcept {
-            return ers::RapidHash<std::string_view> {}(name);
+            return ers::RapidNanoHash<std::string_view> {}(name);
         }
     };
 
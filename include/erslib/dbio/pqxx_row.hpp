@@ -1,11 +1,11 @@
 #pragma once
 
-// std
-#include <functional>
-
 // pqxx
 #include <pqxx/row>
 
+// ers
+#include <erslib/core/memory/function.hpp>
+
 
 namespace dbio::impl {
     // Sequential reader over a pqxx::row_ref.
@@ -54,7 +54,7 @@ namespace dbio::impl {
             return false;
         }
 
-        bool store(const std::function<void(PqxxRow&)>& func, size_type amount = 1) try {
+        bool store(const ers::function<void(PqxxRow&)>& func, size_type amount = 1) try {
             if (!has_next(amount))
                 return false;
 
@@ -0,0 +1,229 @@
+#include "erslib/aengine/bytecode_cache.hpp"
+
+// std
+#include <charconv>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+// ers
+#include <erslib/core/filesystem.hpp>
+#include <erslib/core/hashing/rapid.hpp>
+#include <erslib/core/type/optional.hpp>
+
+
+namespace {
+    constexpr char magic[4] = { 'A', 'E', 'B', 'C' };
+    constexpr std::string_view extension = ".luac";
+
+    // LuaJIT bytecode differs between its releases while "LUA_VERSION_NUM" stays 501.
+#ifdef LUAJIT_VERSION_NUM
+    constexpr u32 lua_build_version = LUAJIT_VERSION_NUM;
+#else
+    constexpr u32 lua_build_version = LUA_VERSION_NUM;
+#endif
+
+
+    int append_chunk(lua_State*, const void* p, size_t size, void* ud) {
+        static_cast<std::string*>(ud)->append(static_cast<const char*>(p), size);
+        return 0;
+    }
+
+
+    ers::optional<u64> parse_id(const fs::path& path) {
+        if (path.extension() != extension)
+            return ers::nullopt;
+
+        const auto stem = path.stem().string();
+        u64 id;
+
+        auto [ptr, ec] = std::from_chars(stem.data(), stem.data() + stem.size(), id, 16);
+        if (ec != std::errc() || ptr != stem.data() + stem.size())
+            return ers::nullopt;
+
+        return id;
+    }
+}
+
+
+// Constructor
+
+aengine::impl::BytecodeCache::BytecodeCache(fs::path dir) :
+    m_dir(std::move(dir)) {
+    std::error_code ec;
+    fs::create_directories(m_dir, ec);
+
+    if (ec)
+        throw ers::make_path_error("Can't create bytecode cache directory '{}': {}", m_dir.string(), ec.message());
+
+
+    for (const auto& it : fs::directory_iterator(m_dir, ec)) {
+        if (!it.is_regular_file())
+            continue;
+
+        auto id = parse_id(it.path());
+        header_t header {};
+
+        bool valid = id.has_value();
+
+        if (valid) {
+            std::ifstream stream(it.path(), std::ios::binary);
+            stream.read(reinterpret_cast<char*>(&header), sizeof(header));
+
+            valid = stream
+                && std::memcmp(header.magic, magic, sizeof(magic)) == 0
+                && header.format == format_version
+                && header.lua_version == lua_build_version
+                && it.file_size() == sizeof(header) + header.size;
+        }
+
+        if (!valid) {
+            fs::remove(it.path(), ec);
+            continue;
+        }
+
+        m_entries.emplace(*id, entry_t {
+            .version      = { header.major, header.minor, header.patch },
+            .content_hash = header.content_hash
+        });
+    }
+}
+
+
+// Modifiers
+
+sol::load_result aengine::impl::BytecodeCache::load(
+    sol::state_view& lua,
+    const ModIdentity& mod,
+    std::string_view path,
+    std::string_view source,
+    const std::string& chunk_name
+) {
+    const u64 id = ers::RapidHash<std::string_view> {}(path, ers::RapidHash<std::string_view> {}(mod.name));
+    const entry_t expected = {
+        .version      = mod.version,
+        .content_hash = ers::RapidUnrolledHash<std::string_view> {}(source)
+    };
+
+
+    bool cached;
+
+    {
+        std::shared_lock lock(m_mutex);
+        auto it = m_entries.find(id);
+
+        cached = it != m_entries.end()
+            && it->second.version == expected.version
+            && it->second.content_hash == expected.content_hash;
+    }
+
+    if (std::string bytecode; cached && _read(id, expected, bytecode)) {
+        auto result = lua.load(bytecode, chunk_name, sol::load_mode::binary);
+
+        if (result.valid())
+            return result;
+
+        // Broken file, it's compiled and rewritten below.
+    }
+
+
+    auto result = lua.load(source, chunk_name, sol::load_mode::text);
+
+    if (!result.valid())
+        return result;
+
+    std::string bytecode;
+    lua_State* L = lua.lua_state();
+
+    lua_pushvalue(L, result.stack_index());
+#if LUA_VERSION_NUM >= 503
+    lua_dump(L, &append_chunk, &bytecode, 0);
+#else
+    lua_dump(L, &append_chunk, &bytecode);
+#endif
+    lua_pop(L, 1);
+
+    _write(id, expected, bytecode);
+
+
+    return result;
+}
+
+
+// Observers
+
+size_t aengine::impl::BytecodeCache::size() const {
+    std::shared_lock lock(m_mutex);
+    return m_entries.size();
+}
+
+
+// Details
+
+fs::path aengine::impl::BytecodeCache::_path_of(u64 id) const {
+    return m_dir / std::format("{:016x}{}", id, extension);
+}
+
+bool aengine::impl::BytecodeCache::_read(u64 id, const entry_t& expected, std::string& out) const {
+    std::ifstream stream(_path_of(id), std::ios::binary);
+    header_t header {};
+
+    if (!stream.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        return false;
+
+    // Another process could have rewritten the file since it was indexed.
+    if (ers::version_t { header.major, header.minor, header.patch } != expected.version
+        || header.content_hash != expected.content_hash)
+        return false;
+
+    out.resize(header.size);
+    return static_cast<bool>(stream.read(out.data(), static_cast<std::streamsize>(out.size())));
+}
+
+// Best effort: a file that can't be written just means compiling again next time.
+void aengine::impl::BytecodeCache::_write(u64 id, const entry_t& entry, std::string_view bytecode) {
+    header_t header {
+        .format       = format_version,
+        .lua_version  = lua_build_version,
+        .reserved     = 0,
+        .major        = entry.version.major,
+        .minor        = entry.version.minor,
+        .patch        = entry.version.patch,
+        .content_hash = entry.content_hash,
+        .size         = bytecode.size()
+    };
+    std::memcpy(header.magic, magic, sizeof(magic));
+
+
+    // Written aside and renamed, so readers never see a half-written file.
+    const auto path = _path_of(id);
+    auto temp = path;
+    temp += std::format(".{}", std::hash<std::thread::id> {}(std::this_thread::get_id()));
+
+    std::error_code ec;
+
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        stream.write(bytecode.data(), static_cast<std::streamsize>(bytecode.size()));
+
+        if (!stream) {
+            stream.close();
+            fs::remove(temp, ec);
+            return;
+        }
+    }
+
+    fs::rename(temp, path, ec);
+
+    if (ec) {
+        fs::remove(temp, ec);
+        return;
+    }
+
+
+    std::unique_lock lock(m_mutex);
+    m_entries.insert_or_assign(id, entry);
+}
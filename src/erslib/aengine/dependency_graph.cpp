@@ -1,136 +1,478 @@
 #include "erslib/aengine/dependency_graph.hpp"
 
 // std
-#include <deque>
+#include <algorithm>
+#include <exception>
+#include <format>
+#include <memory_resource>
 #include <ranges>
+#include <unordered_map>
 
 // ers
 #include <erslib/aengine/util/stage.hpp>
+#include <erslib/contrib/json.hpp>
+#include <erslib/core/hashing/rapid.hpp>
+#include <erslib/core/memory/scratch_arena.hpp>
 #include <erslib/core/ranges.hpp>
 
 
-std::vector<std::string> aengine::impl::resolve_mods_order(const ModContainer& mods, std::string_view initial_mod) {
-    // Step 0: preparing
+// Internal
 
-    ers::StringMap<std::vector<std::string>> outgoing;
-    ers::StringMap<size_t> indegree;
+namespace {
+    using id_type = aengine::DependencyGraph::id_type;
 
 
-    // Step 1: registering every mod
+    u64 hash_mod(const aengine::Mod& mod) {
+        const auto& v = mod.version();
+        u64 result = ers::RapidHash<std::string_view> {}(std::format("{}@{}.{}.{}", mod.name(), v.major, v.minor, v.patch));
 
-    for (const auto& mod : mods) {
-        outgoing.try_emplace(mod.name());
-        indegree.emplace(mod.name(), 0);
+        // Dependencies come from a hash set, so they are summed to not depend on its order.
+        u64 dependencies = 0;
+
+        for (const auto& dep : mod.metadata().dependencies) {
+            dependencies += ers::RapidHash<std::string_view> {}(std::format("{}:{}:{}:{}.{}.{}",
+                dep.name, static_cast<u32>(dep.type), static_cast<u32>(dep.limit),
+                dep.version.major, dep.version.minor, dep.version.patch));
+        }
+
+        return ers::RapidHash<std::string_view> {}(std::format("{:016x}{:016x}", result, dependencies));
     }
 
+    bool is_ordering(aengine::DependencyType type) {
+        return type == aengine::DependencyType::Required || type == aengine::DependencyType::Optional;
+    }
+}
 
-    // Step 2: Building graph
 
-    for (const Mod& mod : mods) {
-        for (const dependency_t& dep : mod.metadata().dependencies) {
-            auto it = mods.find(dep.name);
-            bool dependency_exist = it != mods.end(),
-                 add_to_graph = false;
+// DependencyGraph
 
+void aengine::impl::DependencyGraph::reserve(size_t n) {
+    m_ids.reserve(n);
+    m_nodes.reserve(n);
+}
 
-            // It wil be converted to jump table anyway and as a switch-case this block would be much clankier.
 
-            if (dep.type == DependencyType::Required) {
-                if (!dependency_exist) {
-                    throw make_dependency_error("Required dependency '{}' for mod '{}' is missing.",
-                        dep.name, mod.name());
-                }
+void aengine::impl::DependencyGraph::add(const Mod& mod) {
+    const id_type id = _intern(mod.name());
 
-                add_to_graph = true;
-            } else if (dep.type == DependencyType::Optional) {
-                if (dependency_exist)
-                    continue;
+    if (m_nodes[id].present)
+        throw make_dependency_error("Mod '{}' is added twice.", mod.name());
 
-                add_to_graph = true;
-            } else if (dep.type == DependencyType::Incompatible) {
-                if (dependency_exist) {
-                    throw make_dependency_error("Mod '{}' is incompatible with loaded mod '{}'.",
-                        mod.name(), dep.name);
-                }
-            }
 
+    std::vector<edge_t> dependencies;
+    dependencies.reserve(mod.metadata().dependencies.size());
 
-            if (add_to_graph) {
-                outgoing[dep.name].emplace_back(mod.name());
-                indegree[mod.name()]++;
-            }
+    for (const auto& dep : mod.metadata().dependencies) {
+        const id_type dep_id = _intern(dep.name);
+
+        dependencies.push_back({ .id = dep_id, .type = dep.type });
+        m_nodes[dep_id].referrers.push_back({ .id = id, .type = dep.type });
+    }
+
+
+    auto& node = m_nodes[id];
+
+    node.present = true;
+    node.hash = hash_mod(mod);
+    node.dependencies = std::move(dependencies);
+
+    m_present++;
+    m_fingerprint += node.hash;
+
+
+    // Appending keeps the order valid if nobody waits for this mod and its own constraints hold.
+
+    if (!m_order_valid)
+        return;
+
+    bool appendable = !_has_present_referrers(node);
+
+    for (const auto& dep : node.dependencies) {
+        const bool present = m_nodes[dep.id].present;
+
+        if ((dep.type == DependencyType::Required && !present) || (dep.type == DependencyType::Incompatible && present))
+            appendable = false;
+    }
+
+    if (appendable)
+        m_order.push_back(id);
+    else
+        m_order_valid = false;
+}
+
+bool aengine::impl::DependencyGraph::remove(std::string_view name) {
+    auto it = m_ids.find(name);
+
+    if (it == m_ids.end() || !m_nodes[it->second].present)
+        return false;
+
+
+    const id_type id = it->second;
+    auto& node = m_nodes[id];
+
+    for (const auto& dep : node.dependencies) {
+        std::erase_if(m_nodes[dep.id].referrers, [id](const edge_t& e) { return e.id == id; });
+    }
+
+    node.present = false;
+    node.dependencies.clear();
+
+    m_present--;
+    m_fingerprint -= node.hash;
+
+
+    // Nobody refers to it, so erasing it can't break the order, the initial mod is a special case.
+
+    if (m_order_valid && (_has_present_referrers(node) || node.name == m_order_initial))
+        m_order_valid = false;
+
+    if (m_order_valid)
+        std::erase(m_order, id);
+
+    return true;
+}
+
+
+bool aengine::impl::DependencyGraph::contains(std::string_view name) const {
+    auto it = m_ids.find(name);
+    return it != m_ids.end() && m_nodes[it->second].present;
+}
+
+
+const std::vector<aengine::impl::DependencyGraph::id_type>& aengine::impl::DependencyGraph::order(std::string_view initial_mod) {
+    if (!m_order_valid || m_order_initial != initial_mod) {
+        _validate(initial_mod);
+        _sort(initial_mod);
+    }
+
+    return m_order;
+}
+
+std::vector<std::string> aengine::impl::DependencyGraph::order_names(std::string_view initial_mod) {
+    std::vector<std::string> result;
+
+    for (id_type id : order(initial_mod))
+        result.emplace_back(m_nodes[id].name);
+
+    return result;
+}
+
+
+std::vector<std::vector<aengine::impl::DependencyGraph::id_type>> aengine::impl::DependencyGraph::levels(std::string_view initial_mod) {
+    const auto& ids = order(initial_mod);
+
+    std::vector<u32> level_of(m_nodes.size(), 0);
+    std::vector<std::vector<id_type>> result;
+
+    for (id_type id : ids) {
+        u32 level = id == ids.front() ? 0 : 1;
+
+        for (const auto& dep : m_nodes[id].dependencies) {
+            if (is_ordering(dep.type) && m_nodes[dep.id].present)
+                level = std::max(level, level_of[dep.id] + 1);
         }
+
+        level_of[id] = level;
+
+        if (result.size() <= level)
+            result.resize(level + 1);
+
+        result[level].push_back(id);
     }
 
+    return result;
+}
 
-    // Step 3: Kahn queue
 
-    std::deque<std::string> ready;
-    ers::StringSet queued;
+void aengine::impl::DependencyGraph::save_order(const fs::path& path) const {
+    if (!m_order_valid)
+        return;
 
-    {
-        auto it = indegree.find(initial_mod);
+    utl::Json json;
 
-        if (it == indegree.end())
-            throw make_dependency_error("Initial mod '{}' does not exist. Files are probably corrupted.", initial_mod);
+    json["format"] = static_cast<utl::Integral>(format_version);
+    json["fingerprint"] = std::format("{:016x}", m_fingerprint);
+    json["initial"] = m_order_initial;
 
-        if (it->second != 0)
-            throw make_dependency_error("Initial mod '{}' unexpectedly has dependencies.", initial_mod);
+    utl::Array names;
+    names.reserve(m_order.size());
+
+    for (id_type id : m_order)
+        names.emplace_back(m_nodes[id].name);
+
+    json["order"] = std::move(names);
+
+    json.to_file(path);
+}
+
+bool aengine::impl::DependencyGraph::load_order(const fs::path& path, std::string_view initial_mod) {
+    if (!fs::is_regular_file(path))
+        return false;
 
-        ready.emplace_back(initial_mod);
-        queued.emplace(initial_mod);
+
+    utl::Json json;
+
+    try {
+        json = utl::from_file(path);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    if (!json.is_object())
+        return false;
+
+
+    const auto& format = json.at_or_dummy("format");
+    const auto& fingerprint = json.at_or_dummy("fingerprint");
+    const auto& initial = json.at_or_dummy("initial");
+    const auto& names = json.at_or_dummy("order");
+
+    if (!format.is_integral() || format.as_integral() != static_cast<utl::Integral>(format_version))
+        return false;
+
+    if (!fingerprint.is_string() || fingerprint.as_string() != std::format("{:016x}", m_fingerprint))
+        return false;
+
+    if (!initial.is_string() || initial.as_string() != initial_mod)
+        return false;
+
+    if (!names.is_array() || names.as_array().size() != m_present)
+        return false;
+
+
+    // A name listed twice would leave another mod out while the size still matches.
+    std::vector<id_type> order;
+    std::vector<bool> seen(m_nodes.size(), false);
+    order.reserve(m_present);
+
+    for (const auto& name : names.as_array()) {
+        if (!name.is_string())
+            return false;
+
+        auto it = m_ids.find(name.as_string());
+        if (it == m_ids.end() || !m_nodes[it->second].present || seen[it->second])
+            return false;
+
+        seen[it->second] = true;
+        order.push_back(it->second);
     }
 
-    for (const auto& [name, degree] : indegree) {
-        if (degree != 0 || queued.contains(name))
+
+    m_order = std::move(order);
+    m_order_initial = initial_mod;
+    m_order_valid = true;
+
+    return true;
+}
+
+
+aengine::impl::DependencyGraph::id_type aengine::impl::DependencyGraph::_intern(std::string_view name) {
+    if (auto it = m_ids.find(name); it != m_ids.end())
+        return it->second;
+
+    const auto id = static_cast<id_type>(m_nodes.size());
+
+    m_ids.emplace(std::string(name), id);
+    m_nodes.push_back({ .name = std::string(name) });
+
+    return id;
+}
+
+
+bool aengine::impl::DependencyGraph::_has_present_referrers(const node_t& node) const {
+    return std::ranges::any_of(node.referrers, [this](const edge_t& e) { return m_nodes[e.id].present; });
+}
+
+void aengine::impl::DependencyGraph::_validate(std::string_view initial_mod) const {
+    for (const auto& node : m_nodes) {
+        if (!node.present)
             continue;
 
-        ready.emplace_back(name);
-        queued.emplace(name);
+        for (const auto& dep : node.dependencies) {
+            const auto& target = m_nodes[dep.id];
+
+            if (dep.type == DependencyType::Required && !target.present) {
+                throw make_dependency_error("Required dependency '{}' for mod '{}' is missing.",
+                    target.name, node.name);
+            }
+
+            if (dep.type == DependencyType::Incompatible && target.present) {
+                throw make_dependency_error("Mod '{}' is incompatible with loaded mod '{}'.",
+                    node.name, target.name);
+            }
+        }
     }
 
 
-    // Step 4: Topological sort
+    auto it = m_ids.find(initial_mod);
 
-    std::vector<std::string> mods_order;
-    size_t visited_count = 0;
+    if (it == m_ids.end() || !m_nodes[it->second].present)
+        throw make_dependency_error("Initial mod '{}' does not exist. Files are probably corrupted.", initial_mod);
 
-    mods_order.reserve(mods.size());
+    for (const auto& dep : m_nodes[it->second].dependencies) {
+        if (is_ordering(dep.type) && m_nodes[dep.id].present)
+            throw make_dependency_error("Initial mod '{}' unexpectedly has dependencies.", initial_mod);
+    }
+}
 
-    while (!ready.empty()) {
-        auto current = std::move(ready.front());
-        ready.pop_front();
+void aengine::impl::DependencyGraph::_sort(std::string_view initial_mod) {
+    // Step 1: in-degrees over present mods and ordering dependencies
 
-        mods_order.emplace_back(current);
-        visited_count++;
+    std::vector<u32> indegree(m_nodes.size(), 0);
 
-        for (const auto& dependent : outgoing.at(current)) {
-            auto it = indegree.find(dependent);
+    for (id_type id = 0; id < m_nodes.size(); id++) {
+        if (!m_nodes[id].present)
+            continue;
 
-            if (it == indegree.end())
-                continue;
+        for (const auto& dep : m_nodes[id].dependencies) {
+            if (is_ordering(dep.type) && m_nodes[dep.id].present)
+                indegree[id]++;
+        }
+    }
 
-            it->second--;
 
-            if (it->second != 0 || queued.contains(dependent))
+    // Step 2: Kahn queue, the initial mod goes first, then ids in the order mods were added
+
+    const id_type initial = m_ids.find(initial_mod)->second;
+
+    std::vector<id_type> order;
+    order.reserve(m_present);
+    order.push_back(initial);
+
+    for (id_type id = 0; id < m_nodes.size(); id++) {
+        if (m_nodes[id].present && indegree[id] == 0 && id != initial)
+            order.push_back(id);
+    }
+
+
+    // Step 3: Topological sort, "order" is the queue itself
+
+    for (size_t head = 0; head < order.size(); head++) {
+        for (const auto& referrer : m_nodes[order[head]].referrers) {
+            if (!is_ordering(referrer.type) || !m_nodes[referrer.id].present)
                 continue;
 
-            ready.emplace_back(dependent);
-            queued.emplace(dependent);
+            if (--indegree[referrer.id] == 0)
+                order.push_back(referrer.id);
         }
     }
 
 
-    // Step 5: Finishing with finding dependency cycles
+    // Step 4: Finishing with finding dependency cycles
 
-    if (visited_count != indegree.size()) {
+    if (order.size() != m_present) {
         throw make_dependency_error("Occured dependency cycle detected between mods: {}",
-            indegree
-            | ers::views::filter([](const auto& it) { return it.second != 0; })
-            | std::views::keys);
+            std::views::iota(id_type(0), static_cast<id_type>(m_nodes.size()))
+            | ers::views::filter([this, &indegree](id_type id) { return m_nodes[id].present && indegree[id] != 0; })
+            | std::views::transform([this](id_type id) -> std::string_view { return m_nodes[id].name; }));
+    }
+
+
+    m_order = std::move(order);
+    m_order_initial = initial_mod;
+    m_order_valid = true;
+}
+
+
+// Resolution
+
+std::vector<std::string> aengine::impl::resolve_mods_order(
+    const ModContainer& mods,
+    std::string_view initial_mod,
+    const fs::path& order_cache
+) {
+    DependencyGraph graph;
+    graph.reserve(mods.size());
+
+    for (const auto& mod : mods)
+        graph.add(mod);
+
+
+    if (order_cache.empty() || graph.load_order(order_cache, initial_mod))
+        return graph.order_names(initial_mod);
+
+    auto order = graph.order_names(initial_mod);
+
+    // The cache only saves time on the next start, failing to write it isn't a reason to not load mods.
+    try {
+        graph.save_order(order_cache);
+    } catch (const std::exception&) {
     }
 
-    return mods_order;
+    return order;
+}
+
+std::vector<aengine::impl::stage_order_info_t> aengine::impl::order_stages(
+    std::span<const stage_ref_t> stages,
+    std::span<const std::string> mods_order,
+    std::span<const std::string> phases_order
+) {
+    // Every temporary lives on the scratch arena, only the result touches the heap.
+
+    auto& arena = ers::ScratchArena::local();
+    auto scope = arena.checkpoint();
+
+
+    // Step 1: ranking mods and phases by their order
+
+    std::pmr::unordered_map<std::string_view, size_t> mod_ranks(&arena), phase_ranks(&arena);
+    mod_ranks.reserve(mods_order.size());
+    phase_ranks.reserve(phases_order.size());
+
+    for (size_t i = 0; i < mods_order.size(); i++)
+        mod_ranks.try_emplace(mods_order[i], i);
+    for (size_t i = 0; i < phases_order.size(); i++)
+        phase_ranks.try_emplace(phases_order[i], i);
+
+
+    // Step 2: keeping stages of ordered mods and phases
+
+    struct entry_t {
+        size_t phase;
+        size_t mod;
+        size_t index;
+
+        auto operator<=>(const entry_t&) const = default;
+    };
+
+    std::pmr::vector<entry_t> entries(&arena);
+    entries.reserve(stages.size());
+
+    for (const auto& stage : stages) {
+        auto mod_it = mod_ranks.find(stage.mod);
+        if (mod_it == mod_ranks.end())
+            continue;
+
+        auto phase_it = phase_ranks.find(stage.phase);
+        if (phase_it == phase_ranks.end())
+            continue;
+
+        entries.emplace_back(entry_t {
+            .phase = phase_it->second,
+            .mod   = mod_it->second,
+            .index = stage.index
+        });
+    }
+
+
+    // Step 3: ordering by phase, then by mod, then by index
+
+    std::ranges::sort(entries);
+    entries.erase(std::ranges::unique(entries).begin(), entries.end());
+
+    std::vector<stage_order_info_t> stages_order;
+    stages_order.reserve(entries.size());
+
+    for (const auto& entry : entries) {
+        stages_order.emplace_back(stage_order_info_t {
+            .mod   = mods_order[entry.mod],
+            .phase = phases_order[entry.phase],
+            .index = entry.index
+        });
+    }
+
+
+    return stages_order;
 }
 
 std::vector<aengine::impl::stage_order_info_t> aengine::impl::resolve_stages_order(
@@ -138,33 +480,58 @@ std::vector<aengine::impl::stage_order_info_t> aengine::impl::resolve_stages_ord
     std::span<const std::string> mods_order,
     std::span<const std::string> phases_order
 ) {
-    ers::StringMap<ers::StringMap<ers::OrderedSet<size_t>>> indexes_per_mod;
-    size_t stages_count = 0;
+    auto& arena = ers::ScratchArena::local();
+    auto scope = arena.checkpoint();
+
+    std::pmr::vector<stage_ref_t> stages(&arena);
 
     for (const auto& mod : mods) {
-        for (const auto& stage : mod.content().stages | std::views::keys) {
-            auto [phase, index] = util::extract_stage_info(stage);
-            indexes_per_mod[mod.name()][phase].emplace(index);
-            stages_count++;
-        }
+        for (const auto& info : mod.content().stage_infos | std::views::values)
+            stages.emplace_back(stage_ref_t { .mod = mod.name(), .phase = info.phase, .index = info.index });
     }
 
+    return order_stages(stages, mods_order, phases_order);
+}
 
-    std::vector<stage_order_info_t> stages_order;
-    stages_order.reserve(stages_count);
+std::vector<aengine::impl::stage_group_t> aengine::impl::resolve_stage_groups(
+    const ModContainer& mods,
+    DependencyGraph& graph,
+    std::string_view initial_mod,
+    std::span<const std::string> phases_order
+) {
+    const auto levels = graph.levels(initial_mod);
+
+    std::vector<stage_group_t> groups;
 
     for (const auto& phase : phases_order) {
-        for (const auto& mod : mods_order) {
-            for (const auto& index : indexes_per_mod[mod][phase]) {
-                stages_order.emplace_back(stage_order_info_t {
-                    .mod   = mod,
-                    .phase = phase,
-                    .index = index
-                });
+        for (const auto& level : levels) {
+            stage_group_t group { .phase = phase };
+
+            for (auto id : level) {
+                auto it = mods.find(graph.name_of(id));
+                if (it == mods.end())
+                    continue;
+
+                mod_stages_t stages { .mod = std::string(it->name()) };
+
+                for (const auto& info : it->content().stage_infos | std::views::values) {
+                    if (info.phase == phase)
+                        stages.indexes.push_back(info.index);
+                }
+
+                if (stages.indexes.empty())
+                    continue;
+
+                std::ranges::sort(stages.indexes);
+                stages.indexes.erase(std::ranges::unique(stages.indexes).begin(), stages.indexes.end());
+
+                group.mods.push_back(std::move(stages));
             }
+
+            if (!group.mods.empty())
+                groups.push_back(std::move(group));
         }
     }
 
-
-    return stages_order;
+    return groups;
 }
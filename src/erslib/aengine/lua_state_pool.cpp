@@ -0,0 +1,115 @@
+#include "erslib/aengine/lua_state_pool.hpp"
+
+// std
+#include <algorithm>
+#include <utility>
+
+// ers
+#include <erslib/aengine/util/sandbox.hpp>
+
+
+// Lease
+
+aengine::impl::LuaStatePool::Lease& aengine::impl::LuaStatePool::Lease::operator=(Lease&& other) noexcept {
+    std::swap(m_pool, other.m_pool);
+    std::swap(m_state, other.m_state);
+    return *this;
+}
+
+aengine::impl::LuaStatePool::Lease::~Lease() {
+    if (m_state)
+        m_pool->_release(std::move(m_state));
+}
+
+
+// Constructor
+
+aengine::impl::LuaStatePool::LuaStatePool(size_t capacity, init_fn init) :
+    m_capacity(capacity),
+    m_init(std::move(init)) {
+    m_idle.reserve(m_capacity);
+}
+
+
+// Modifiers
+
+aengine::impl::LuaStatePool::Lease aengine::impl::LuaStatePool::acquire() {
+    {
+        std::lock_guard lock(m_mutex);
+
+        if (!m_idle.empty()) {
+            auto state = std::move(m_idle.back());
+            m_idle.pop_back();
+            return { this, std::move(state) };
+        }
+    }
+
+    return { this, _create() };
+}
+
+void aengine::impl::LuaStatePool::warm_up(size_t count) {
+    count = std::min(count, m_capacity);
+
+    while (idle() < count) {
+        auto state = _create();
+
+        std::lock_guard lock(m_mutex);
+        if (m_idle.size() < count)
+            m_idle.push_back(std::move(state));
+    }
+}
+
+void aengine::impl::LuaStatePool::clear() {
+    std::vector<std::unique_ptr<sol::state>> temp;
+
+    {
+        std::lock_guard lock(m_mutex);
+        temp.swap(m_idle);
+    }
+}
+
+
+// Observers
+
+size_t aengine::impl::LuaStatePool::idle() const {
+    std::lock_guard lock(m_mutex);
+    return m_idle.size();
+}
+
+
+// Details
+
+void aengine::impl::LuaStatePool::default_init(sol::state& lua) {
+    lua.open_libraries(
+        sol::lib::base,
+        sol::lib::coroutine,
+        sol::lib::math,
+        sol::lib::string,
+        sol::lib::table
+    );
+}
+
+
+std::unique_ptr<sol::state> aengine::impl::LuaStatePool::_create() const {
+    auto state = std::make_unique<sol::state>();
+
+    m_init(*state);
+    util::sandbox_globals(*state);
+
+    return state;
+}
+
+void aengine::impl::LuaStatePool::_release(std::unique_ptr<sol::state> state) noexcept {
+    // A state that can't be cleaned up is closed instead.
+    try {
+        util::restore_sandbox(*state);
+        state->collect_garbage();
+    } catch (...) {
+        return;
+    }
+
+    std::lock_guard lock(m_mutex);
+
+    if (m_idle.size() < m_capacity)
+        m_idle.push_back(std::move(state));
+}
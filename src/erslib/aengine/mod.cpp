@@ -1,9 +1,15 @@
 #include "erslib/aengine/mod.hpp"
 
 // std
+#include <algorithm>
 #include <ranges>
+#include <utility>
+#include <vector>
 
 // ers
+#include <erslib/aengine/bytecode_cache.hpp>
+#include <erslib/aengine/mod_archive.hpp>
+#include <erslib/aengine/util/sandbox.hpp>
 #include <erslib/aescript/error.hpp>
 #include <erslib/aescript/exception.hpp>
 #include <erslib/contrib/json.hpp>
@@ -46,13 +52,51 @@ namespace {
     }
 
 
-    auto extract_info(const fs::path& m_dir) {
-        aengine::impl::ModIdentity identity;
-        aengine::impl::ModMetadata metadata;
+    // If file isn't stage, it should be written as a package
+    // and be available later as include.
+    std::pair<std::string, bool> source_key(
+        const fs::path& relative,
+        const std::function<bool(std::string_view)>& stage_filter
+    ) {
+        auto stem = relative.stem().generic_string();
 
+        if (stage_filter(stem))
+            return { std::move(stem), true };
+
+        // Such files were stages once, as packages they'd silently never run.
+        if (aengine::impl::util::has_padded_stage_index(stem)) {
+            throw ers::make_path_error("Source '{}' is named as a stage with leading zeros in its index, "
+                "they aren't allowed", relative.generic_string());
+        }
 
+        return { path_to_package_name(relative), false };
+    }
+
+    void add_source(aengine::impl::ModContent& content, std::string name, bool is_stage, std::string source) {
+        if (is_stage) {
+            if (auto info = aengine::impl::util::parse_stage_name(name))
+                content.stage_infos.emplace(name, aengine::impl::util::stage_info_t { std::string(info->phase), info->index });
+
+            content.stages.emplace(std::move(name), std::move(source));
+        } else
+            content.packages.emplace(std::move(name), std::move(source));
+    }
+
+
+    utl::Json read_info(const fs::path& m_dir, const aengine::impl::ModArchive* archive) {
         fs::path info_path = m_dir / "info.json";
 
+        if (archive) {
+            auto file = archive->find("info.json");
+
+            if (!file) {
+                throw ers::make_path_error("Mod archive '{}' without 'info.json' is specified",
+                    m_dir.string());
+            }
+
+            return utl::from_string(std::string(file->data));
+        }
+
         if (!fs::exists(info_path)) {
             throw ers::make_path_error("Mod directory '{}' without 'info.json' is specified",
                 info_path.string());
@@ -64,14 +108,21 @@ namespace {
         }
 
 
-        utl::Json json;
-
         try {
-            json = utl::from_file(info_path.string());
+            return utl::from_file(info_path.string());
         } catch (const fs::filesystem_error& e) {
             throw ers::make_path_error("Error during parsing json with path '{}' occured. Info: {}",
                 info_path.string(), e.what());
         }
+    }
+
+
+    auto extract_info(const fs::path& m_dir, const aengine::impl::ModArchive* archive) {
+        aengine::impl::ModIdentity identity;
+        aengine::impl::ModMetadata metadata;
+
+
+        utl::Json json = read_info(m_dir, archive);
 
 
         utl::JsonSchema schema(json);
@@ -107,7 +158,10 @@ aengine::impl::Mod::Mod(fs::path dir) :
 
 
 void aengine::impl::Mod::init_info() {
-    auto [identity, metadata] = extract_info(m_dir);
+    if (m_dir.extension() == ModArchive::extension && !m_archive)
+        m_archive = std::make_shared<const ModArchive>(m_dir);
+
+    auto [identity, metadata] = extract_info(m_dir, m_archive.get());
 
     m_identity = std::move(identity);
     m_metadata = std::make_unique<ModMetadata>(std::move(metadata));
@@ -116,44 +170,126 @@ void aengine::impl::Mod::init_info() {
 void aengine::impl::Mod::init_content(const std::function<bool(std::string_view)>& stage_filter) const {
     content_type content;
 
-    for (const auto& it : fs::recursive_directory_iterator(m_dir)) {
-        auto stem = it.path().stem().generic_string();
-        auto extension = it.path().extension().generic_string();
+    if (m_archive) {
+        for (size_t i = 0; i < m_archive->size(); i++) {
+            const auto file = m_archive->at(i);
+            const fs::path relative(file.path);
 
-        if (extension != ".lua")
-            continue;
+            if (relative.extension() != ".lua")
+                continue;
 
-        // If file isn't stage, it should be written as a package
-        // and be available later as include.
+            auto [name, is_stage] = source_key(relative, stage_filter);
+            add_source(content, std::move(name), is_stage, std::string(file.data));
+        }
+    } else {
+        for (const auto& it : fs::recursive_directory_iterator(m_dir)) {
+            if (it.path().extension() != ".lua")
+                continue;
 
-        if (stage_filter(stem))
-            content.stages.emplace(stem, ers::util::read_file(it));
-        else
-            content.packages.emplace(path_to_package_name(fs::relative(it, m_dir)), ers::util::read_file(it));
+            auto [name, is_stage] = source_key(fs::relative(it, m_dir), stage_filter);
+            add_source(content, std::move(name), is_stage, ers::util::read_file(it));
+        }
     }
 
     m_content = std::make_unique<content_type>(std::move(content));
 }
 
-void aengine::impl::Mod::init_runtime(sol::state_view& lua) const {
-    runtime_type runtime;
+std::vector<std::string> aengine::impl::Mod::reload_files(
+    std::span<const fs::path> files,
+    const std::function<bool(std::string_view)>& stage_filter
+) const {
+    auto& content = *m_content;
+
+    ers::StringSet stages;
+    std::vector<std::string> packages;
+
+    for (const auto& path : files) {
+        if (path.extension() != ".lua")
+            continue;
+
+        auto [name, is_stage] = source_key(fs::relative(path, m_dir), stage_filter);
 
-    {
-        sol::environment env(lua, sol::create, lua.globals());
+        if (is_stage) {
+            content.stages.erase(name);
+            content.stage_infos.erase(name);
+        } else
+            content.packages.erase(name);
 
-        env["__mod_name"] = m_identity.name;
+        // Removed files are only erased, a removed package still invalidates its dependents.
+        if (fs::is_regular_file(path)) {
+            if (is_stage)
+                stages.insert(name);
 
-        env["require"] = _make_require_fn();
+            add_source(content, name, is_stage, ers::util::read_file(path));
+        }
+
+        if (!is_stage)
+            packages.push_back(std::move(name));
+    }
+
+
+    // Modules built from a changed package are stale, and so is everything that required them.
+
+    if (m_runtime) {
+        auto& runtime = *m_runtime;
+        ers::StringSet visited;
+
+        while (!packages.empty()) {
+            auto package = std::move(packages.back());
+            packages.pop_back();
+
+            if (!visited.insert(package).second)
+                continue;
 
-        static constexpr auto nil_fields = { "dofile", "loadfile", "load", "loadstring", "io", "os" };
-        for (const auto& it : nil_fields)
-            env[it] = sol::nil;
+            runtime.modules_cache.erase(package);
 
-        runtime.env = std::move(env);
+            auto it = runtime.dependents.find(package);
+            if (it == runtime.dependents.end())
+                continue;
+
+            for (const auto& requirer : it->second) {
+                if (content.stages.contains(requirer))
+                    stages.insert(requirer);
+                else
+                    packages.push_back(requirer);
+            }
+        }
     }
 
 
+    std::vector<std::string> result(stages.begin(), stages.end());
+    std::ranges::sort(result);
+
+    return result;
+}
+
+void aengine::impl::Mod::init_runtime(sol::state_view& lua, BytecodeCache* bytecode_cache) const {
+    runtime_type runtime;
+    runtime.bytecode_cache = bytecode_cache;
+    runtime.env = sol::environment(lua, sol::create, util::sandbox_globals(lua));
+
     m_runtime = std::make_unique<runtime_type>(std::move(runtime));
+
+    _fill_env();
+}
+
+void aengine::impl::Mod::reset_runtime() const {
+    auto& runtime = *m_runtime;
+
+    std::vector<sol::object> keys;
+    for (const auto& [key, value] : runtime.env)
+        keys.push_back(key);
+
+    for (const auto& key : keys)
+        runtime.env.raw_set(key, sol::lua_nil);
+
+    runtime.modules_cache.clear();
+    runtime.dependents.clear();
+    runtime.loading.clear();
+    runtime.main = sol::lua_nil;
+    runtime.pending_exception = nullptr;
+
+    _fill_env();
 }
 
 void aengine::impl::Mod::load_runtime(std::string_view stage_name) const {
@@ -163,7 +299,7 @@ void aengine::impl::Mod::load_runtime(std::string_view stage_name) const {
 
 
     sol::state_view lua = m_runtime->env.lua_state();
-    sol::load_result chunk = lua.load(it->second, std::format("{}:{}", m_identity.name, stage_name));
+    sol::load_result chunk = _load_chunk(lua, stage_name, it->second);
 
     if (!chunk.valid()) {
         sol::error e = chunk;
@@ -179,7 +315,9 @@ void aengine::impl::Mod::load_runtime(std::string_view stage_name) const {
     }
 
 
+    m_runtime->loading.emplace_back(stage_name);
     sol::protected_function_result result = fn();
+    m_runtime->loading.pop_back();
 
     if (!result.valid()) {
         if (m_runtime->pending_exception) {
@@ -195,7 +333,14 @@ void aengine::impl::Mod::load_runtime(std::string_view stage_name) const {
 }
 
 
-std::function<sol::object(sol::this_state, std::string_view)> aengine::impl::Mod::_make_require_fn() const {
+void aengine::impl::Mod::_fill_env() const {
+    auto& env = m_runtime->env;
+
+    env["__mod_name"] = m_identity.name;
+    env["require"] = _make_require_fn();
+}
+
+ers::function<sol::object(sol::this_state, std::string_view)> aengine::impl::Mod::_make_require_fn() const {
     return [this](sol::this_state ts, std::string_view package_name) -> sol::object {
         sol::state_view lua = ts.lua_state();
 
@@ -203,6 +348,13 @@ std::function<sol::object(sol::this_state, std::string_view)> aengine::impl::Mod
         auto& content = *m_content;
         auto& runtime = *m_runtime;
 
+        if (!runtime.loading.empty()) {
+            auto& requirers = runtime.dependents[std::string(package_name)];
+
+            if (std::ranges::find(requirers, runtime.loading.back()) == requirers.end())
+                requirers.push_back(runtime.loading.back());
+        }
+
         if (auto cache_it = runtime.modules_cache.find(package_name); cache_it != runtime.modules_cache.end())
             return cache_it->second;
 
@@ -217,7 +369,7 @@ std::function<sol::object(sol::this_state, std::string_view)> aengine::impl::Mod
         runtime.modules_cache.emplace(package_name, sol::make_object(lua, true));
 
 
-        auto lr = lua.load(package_it->second, std::format("{}:{}", m_identity.name, package_name));
+        auto lr = _load_chunk(lua, package_name, package_it->second);
 
         if (!lr.valid()) {
             sol::error e = lr;
@@ -238,7 +390,9 @@ std::function<sol::object(sol::this_state, std::string_view)> aengine::impl::Mod
         }
 
 
+        runtime.loading.emplace_back(package_name);
         auto result = pf();
+        runtime.loading.pop_back();
 
         if (!result.valid()) {
             sol::error e = result;
@@ -258,3 +412,12 @@ std::function<sol::object(sol::this_state, std::string_view)> aengine::impl::Mod
         return module;
     };
 }
+
+sol::load_result aengine::impl::Mod::_load_chunk(sol::state_view& lua, std::string_view name, std::string_view source) const {
+    auto chunk_name = std::format("{}:{}", m_identity.name, name);
+
+    if (m_runtime->bytecode_cache)
+        return m_runtime->bytecode_cache->load(lua, m_identity, name, source, chunk_name);
+
+    return lua.load(source, chunk_name);
+}
@@ -0,0 +1,244 @@
+#include "erslib/aengine/mod_archive.hpp"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ers
+#include <erslib/core/exception.hpp>
+#include <erslib/core/filesystem.hpp>
+#include <erslib/core/hashing/rapid.hpp>
+
+
+namespace {
+    constexpr char magic[4] = { 'A', 'E', 'M', 'A' };
+
+
+    u64 hash_of(std::string_view data) {
+        return ers::RapidUnrolledHash<std::string_view> {}(data);
+    }
+
+    std::string read_binary(const fs::path& path) {
+        std::ifstream stream(path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+    }
+
+    template<typename T>
+    void write_pod(std::ofstream& stream, const T& value) {
+        stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+}
+
+
+// Constructor
+
+aengine::impl::ModArchive::ModArchive(const fs::path& path) :
+    m_path(path),
+    m_file(path) {
+    auto corrupted = [this](std::string_view reason) {
+        return ers::make_path_error("Mod archive '{}' is corrupted: {}", m_path.string(), reason);
+    };
+
+
+    header_t header {};
+
+    if (m_file.size() < sizeof(header))
+        throw corrupted("too small");
+
+    std::memcpy(&header, m_file.data(), sizeof(header));
+
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0)
+        throw corrupted("wrong magic");
+
+    if (header.format != format_version)
+        throw ers::make_path_error("Mod archive '{}' has format {}, expected {}", m_path.string(), header.format, format_version);
+
+
+    // Bounds are checked so that the accessors don't have to.
+
+    const u64 file_size = m_file.size();
+    const u64 blobs_end = header.index_offset;
+
+    if (header.index_offset < sizeof(header)
+        || header.index_offset > file_size
+        || header.count > (file_size - header.index_offset) / sizeof(entry_t)
+        || header.paths_offset != header.index_offset + header.count * sizeof(entry_t)
+        || header.paths_size > file_size - header.paths_offset)
+        throw corrupted("index is out of bounds");
+
+    m_count = header.count;
+    m_index = m_file.data() + header.index_offset;
+    m_paths = m_file.data() + header.paths_offset;
+
+    std::string_view previous;
+
+    for (size_t i = 0; i < m_count; i++) {
+        const auto entry = _entry(i);
+
+        if (entry.compression != ArchiveCompression::None)
+            throw corrupted("unknown compression");
+
+        if (entry.offset < sizeof(header) || entry.offset > blobs_end || entry.size > blobs_end - entry.offset)
+            throw corrupted("file is out of bounds");
+
+        if (entry.path_offset > header.paths_size || entry.path_size > header.paths_size - entry.path_offset)
+            throw corrupted("path is out of bounds");
+
+        // "find" relies on it.
+        const std::string_view path(m_paths + entry.path_offset, entry.path_size);
+
+        if (i > 0 && path <= previous)
+            throw corrupted("index isn't sorted");
+
+        previous = path;
+    }
+}
+
+
+// Accessors
+
+aengine::impl::ModArchive::file_t aengine::impl::ModArchive::at(size_t index) const {
+    if (index >= m_count)
+        throw ers::make_out_of_range_error("Mod archive '{}' has {} files, index {} is out of range", m_path.string(), m_count, index);
+
+    return _file(_entry(index));
+}
+
+ers::optional<aengine::impl::ModArchive::file_t> aengine::impl::ModArchive::find(std::string_view path) const {
+    size_t lo = 0, hi = m_count;
+
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        const auto entry = _entry(mid);
+        const std::string_view current(m_paths + entry.path_offset, entry.path_size);
+
+        if (current == path)
+            return _file(entry);
+
+        if (current < path)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return ers::nullopt;
+}
+
+
+// Observers
+
+bool aengine::impl::ModArchive::verify() const {
+    for (size_t i = 0; i < m_count; i++) {
+        const auto file = at(i);
+
+        if (hash_of(file.data) != file.hash)
+            return false;
+    }
+
+    return true;
+}
+
+
+// Details
+
+aengine::impl::ModArchive::entry_t aengine::impl::ModArchive::_entry(size_t index) const {
+    entry_t entry;
+    std::memcpy(&entry, m_index + index * sizeof(entry_t), sizeof(entry_t));
+    return entry;
+}
+
+aengine::impl::ModArchive::file_t aengine::impl::ModArchive::_file(const entry_t& entry) const {
+    return {
+        .path = { m_paths + entry.path_offset, entry.path_size },
+        .data = { m_file.data() + entry.offset, entry.size },
+        .hash = entry.hash
+    };
+}
+
+
+// Packing
+
+void aengine::impl::pack_mod_archive(const fs::path& dir, const fs::path& archive) {
+    using header_t = ModArchive::header_t;
+    using entry_t = ModArchive::entry_t;
+
+
+    if (!fs::is_directory(dir))
+        throw ers::make_path_error("Mod directory '{}' doesn't exist", dir.string());
+
+    std::vector<std::string> paths;
+
+    for (const auto& it : fs::recursive_directory_iterator(dir)) {
+        if (it.is_regular_file())
+            paths.push_back(fs::relative(it.path(), dir).generic_string());
+    }
+
+    std::ranges::sort(paths);
+
+
+    const auto temp = fs::path(archive) += ".tmp";
+
+    {
+        std::ofstream stream(temp, std::ios::binary | std::ios::trunc);
+        if (!stream)
+            throw ers::make_path_error("Can't write mod archive '{}'", temp.string());
+
+        header_t header {};
+        write_pod(stream, header);
+
+
+        std::vector<entry_t> entries;
+        entries.reserve(paths.size());
+
+        u64 offset = sizeof(header_t);
+        u64 path_offset = 0;
+
+        for (const auto& path : paths) {
+            const auto data = read_binary(dir / path);
+
+            entries.push_back(entry_t {
+                .path_offset = path_offset,
+                .path_size   = static_cast<u32>(path.size()),
+                .compression = ArchiveCompression::None,
+                .offset      = offset,
+                .size        = data.size(),
+                .hash        = hash_of(data)
+            });
+
+            stream.write(data.data(), static_cast<std::streamsize>(data.size()));
+
+            offset += data.size();
+            path_offset += path.size();
+        }
+
+
+        for (const auto& entry : entries)
+            write_pod(stream, entry);
+
+        for (const auto& path : paths)
+            stream.write(path.data(), static_cast<std::streamsize>(path.size()));
+
+
+        std::memcpy(header.magic, magic, sizeof(magic));
+        header.format = ModArchive::format_version;
+        header.count = entries.size();
+        header.index_offset = offset;
+        header.paths_offset = offset + entries.size() * sizeof(entry_t);
+        header.paths_size = path_offset;
+
+        stream.seekp(0);
+        write_pod(stream, header);
+
+        if (!stream) {
+            stream.close();
+            std::error_code ec;
+            fs::remove(temp, ec);
+            throw ers::make_path_error("Can't write mod archive '{}'", temp.string());
+        }
+    }
+
+    fs::rename(temp, archive);
+}
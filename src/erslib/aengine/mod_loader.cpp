@@ -0,0 +1,111 @@
+#include "erslib/aengine/mod_loader.hpp"
+
+// std
+#include <algorithm>
+#include <exception>
+#include <future>
+
+// ers
+#include <erslib/aengine/dependency_graph.hpp>
+#include <erslib/aengine/mod_archive.hpp>
+#include <erslib/core/filesystem.hpp>
+
+
+namespace {
+    std::vector<fs::path> list_mod_dirs(std::span<const fs::path> roots) {
+        std::vector<fs::path> result;
+
+        for (const auto& root : roots) {
+            if (!fs::is_directory(root))
+                throw ers::make_path_error("Mods directory '{}' doesn't exist", root.string());
+
+            const size_t first = result.size();
+
+            for (const auto& it : fs::directory_iterator(root)) {
+                if (it.is_directory() || (it.is_regular_file() && it.path().extension() == aengine::ModArchive::extension))
+                    result.emplace_back(it.path());
+            }
+
+            // Directory iteration order is unspecified, sorting keeps the reported error the same between runs.
+            std::ranges::sort(result.begin() + static_cast<std::ptrdiff_t>(first), result.end());
+        }
+
+        return result;
+    }
+}
+
+
+aengine::impl::ModContainer aengine::impl::discover_mods(
+    std::span<const fs::path> roots,
+    const std::function<bool(std::string_view)>& stage_filter,
+    ers::thread_safe::WorkerPool& pool
+) {
+    auto dirs = list_mod_dirs(roots);
+
+
+    std::vector<std::future<Mod>> pending;
+    pending.reserve(dirs.size());
+
+    for (auto& dir : dirs) {
+        pending.push_back(pool.submit([&stage_filter, dir = std::move(dir)] {
+            Mod mod(dir);
+            mod.init_info();
+            mod.init_content(stage_filter);
+            return mod;
+        }));
+    }
+
+
+    // Every future is waited for even after a failure, tasks still reference "stage_filter".
+
+    ModContainer result;
+    std::exception_ptr error = nullptr;
+
+    result.reserve(pending.size());
+
+    for (auto& future : pending) {
+        try {
+            Mod mod = future.get();
+
+            if (auto it = result.find(mod.name()); it != result.end()) {
+                throw ers::make_path_error("Mod '{}' is installed twice: '{}' and '{}'",
+                    mod.name(), it->dir().string(), mod.dir().string());
+            }
+
+            result.emplace(std::move(mod));
+        } catch (...) {
+            if (!error)
+                error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+
+
+    return result;
+}
+
+aengine::impl::ModContainer aengine::impl::discover_mods(
+    std::span<const fs::path> roots,
+    const std::function<bool(std::string_view)>& stage_filter
+) {
+    ers::thread_safe::WorkerPool pool;
+    return discover_mods(roots, stage_filter, pool);
+}
+
+
+aengine::impl::loaded_mods_t aengine::impl::load_mods(
+    std::span<const fs::path> roots,
+    std::string_view initial_mod,
+    const std::function<bool(std::string_view)>& stage_filter,
+    ers::thread_safe::WorkerPool& pool,
+    const fs::path& order_cache
+) {
+    loaded_mods_t result;
+
+    result.mods = discover_mods(roots, stage_filter, pool);
+    result.order = resolve_mods_order(result.mods, initial_mod, order_cache);
+
+    return result;
+}
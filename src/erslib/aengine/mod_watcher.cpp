@@ -0,0 +1,373 @@
+#include "erslib/aengine/mod_watcher.hpp"
+
+// std
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ranges>
+#include <thread>
+#include <utility>
+
+// ers
+#include <erslib/core/filesystem.hpp>
+
+#ifdef __linux__
+// linux
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+    constexpr std::string_view info_file = "info.json";
+
+#ifdef __linux__
+    constexpr u32 watch_mask = IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+#endif
+
+
+    // Editors write a file several times per save, changes are merged per mod and per file.
+    class change_set_t {
+    public:
+        void add(const std::string& mod, const fs::path& root, const fs::path& path) {
+            auto& change = _change_of(mod);
+
+            if (path.parent_path() == root && path.filename() == info_file)
+                change.reinit = true;
+            else if (path.extension() == ".lua" && std::ranges::find(change.files, path) == change.files.end())
+                change.files.push_back(path);
+        }
+
+        void reinit(const std::string& mod) {
+            _change_of(mod).reinit = true;
+        }
+
+        std::vector<aengine::impl::mod_change_t> take() {
+            m_index.clear();
+            return std::move(m_changes);
+        }
+
+
+    private:
+        aengine::impl::mod_change_t& _change_of(const std::string& mod) {
+            auto [it, inserted] = m_index.try_emplace(mod, m_changes.size());
+
+            if (inserted)
+                m_changes.emplace_back().mod = mod;
+
+            return m_changes[it->second];
+        }
+
+
+        ers::StringMap<size_t> m_index;
+        std::vector<aengine::impl::mod_change_t> m_changes;
+    };
+
+
+#ifdef __linux__
+    bool is_within(const fs::path& path, const fs::path& dir) {
+        auto [it, _] = std::mismatch(dir.begin(), dir.end(), path.begin(), path.end());
+        return it == dir.end();
+    }
+#endif
+}
+
+
+// Constructor
+
+aengine::impl::ModWatcher::ModWatcher(const ModContainer& mods) {
+#ifdef __linux__
+    m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+
+    if (m_fd < 0)
+        throw ers::make_path_error("Can't initialize inotify: {}", std::strerror(errno));
+#endif
+
+    for (const auto& mod : mods)
+        watch(mod);
+}
+
+
+// Destructor
+
+aengine::impl::ModWatcher::~ModWatcher() {
+#ifdef __linux__
+    if (m_fd >= 0)
+        close(m_fd);
+#endif
+}
+
+
+// Modifiers
+
+void aengine::impl::ModWatcher::watch(const Mod& mod) {
+    // Archives are rebuilt by packing, not edited in place.
+    if (mod.archive())
+        return;
+
+    const std::string name(mod.name());
+
+    if (!_watch_dir(name, mod.dir(), mod.dir()))
+        throw ers::make_path_error("Can't watch mod directory '{}': {}", mod.dir().string(), std::strerror(errno));
+
+    for (const auto& it : fs::recursive_directory_iterator(mod.dir())) {
+        if (it.is_directory() && !_watch_dir(name, mod.dir(), it.path()))
+            throw ers::make_path_error("Can't watch mod directory '{}': {}", it.path().string(), std::strerror(errno));
+    }
+}
+
+std::vector<aengine::impl::mod_change_t> aengine::impl::ModWatcher::poll(std::chrono::milliseconds timeout) {
+#ifdef __linux__
+    pollfd fd { .fd = m_fd, .events = POLLIN, .revents = 0 };
+    ::poll(&fd, 1, static_cast<int>(timeout.count()));
+#else
+    if (auto result = _collect(); !result.empty() || timeout.count() == 0)
+        return result;
+
+    std::this_thread::sleep_for(timeout);
+#endif
+
+    return _collect();
+}
+
+
+// Details
+
+#ifdef __linux__
+
+bool aengine::impl::ModWatcher::_watch_dir(const std::string& mod, const fs::path& root, const fs::path& dir) {
+    const int wd = inotify_add_watch(m_fd, dir.c_str(), watch_mask);
+
+    if (wd < 0)
+        return false;
+
+    m_watches.insert_or_assign(static_cast<size_t>(wd), watch_t { .mod = mod, .root = root, .dir = dir });
+    return true;
+}
+
+std::vector<aengine::impl::mod_change_t> aengine::impl::ModWatcher::_collect() {
+    change_set_t changes;
+
+    alignas(inotify_event) char buffer[16 * 1024];
+
+    for (;;) {
+        const ssize_t length = read(m_fd, buffer, sizeof(buffer));
+
+        // EAGAIN, everything is read
+        if (length <= 0)
+            break;
+
+        for (const char* ptr = buffer; ptr < buffer + length;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+
+            // Events were dropped by the kernel (wd is -1 here), nothing tells which mods they were about.
+            // Directories created meanwhile are watched too, as their events may be among the lost ones.
+            if (event->mask & IN_Q_OVERFLOW) {
+                std::vector<watch_t> roots;
+
+                for (const auto& watch : m_watches | std::views::values) {
+                    changes.reinit(watch.mod);
+
+                    if (watch.dir == watch.root)
+                        roots.push_back(watch);
+                }
+
+                for (const auto& root : roots) {
+                    std::error_code ec;
+                    for (const auto& entry : fs::recursive_directory_iterator(root.root, ec)) {
+                        if (entry.is_directory())
+                            _watch_dir(root.mod, root.root, entry.path());
+                    }
+                }
+
+                continue;
+            }
+
+            auto it = m_watches.find(static_cast<size_t>(event->wd));
+            if (it == m_watches.end())
+                continue;
+
+            // Copied, new watches may be inserted below.
+            const watch_t watch = it->second;
+
+            if (event->mask & IN_IGNORED) {
+                if (watch.dir == watch.root)
+                    changes.reinit(watch.mod);
+
+                m_watches.erase(it);
+                continue;
+            }
+
+            if (event->len == 0)
+                continue;
+
+            const fs::path path = watch.dir / event->name;
+
+            if (!(event->mask & IN_ISDIR)) {
+                changes.add(watch.mod, watch.root, path);
+                continue;
+            }
+
+
+            if (event->mask & (IN_CREATE | IN_MOVED_TO)) {
+                // Files could have been written before the watch was added, they're reported right away.
+
+                _watch_dir(watch.mod, watch.root, path);
+
+                std::error_code ec;
+                for (const auto& entry : fs::recursive_directory_iterator(path, ec)) {
+                    if (entry.is_directory())
+                        _watch_dir(watch.mod, watch.root, entry.path());
+                    else
+                        changes.add(watch.mod, watch.root, entry.path());
+                }
+            } else {
+                // Sources of a removed directory can't be listed anymore. A moved out one keeps
+                // its watches, they're dropped so its events aren't taken for the old path.
+
+                std::vector<size_t> moved;
+                for (const auto& [wd, other] : m_watches) {
+                    if (is_within(other.dir, path))
+                        moved.push_back(wd);
+                }
+
+                for (auto wd : moved) {
+                    inotify_rm_watch(m_fd, static_cast<int>(wd));
+                    m_watches.erase(wd);
+                }
+
+                changes.reinit(watch.mod);
+            }
+        }
+    }
+
+    return changes.take();
+}
+
+#else
+
+bool aengine::impl::ModWatcher::_watch_dir(const std::string& mod, const fs::path& root, const fs::path& dir) {
+    if (!fs::is_directory(dir))
+        return false;
+
+    m_watches.push_back(watch_t { .mod = mod, .root = root, .dir = dir });
+
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        if (entry.is_regular_file())
+            m_stamps.insert_or_assign(entry.path().string(), stamp_t { entry.last_write_time(), m_watches.size() - 1 });
+    }
+
+    return true;
+}
+
+std::vector<aengine::impl::mod_change_t> aengine::impl::ModWatcher::_collect() {
+    change_set_t changes;
+    ers::StringSet seen;
+
+    // Directories found during the scan are appended and scanned in the same pass.
+    for (size_t i = 0; i < m_watches.size(); i++) {
+        const watch_t watch = m_watches[i];
+
+        if (watch.dir.empty())
+            continue;
+
+        std::error_code ec;
+        fs::directory_iterator dir(watch.dir, ec);
+
+        // Stamps refer to watches by index, a vanished directory only gets its path cleared.
+        if (ec) {
+            m_watches[i].dir.clear();
+            changes.reinit(watch.mod);
+            continue;
+        }
+
+        for (const auto& entry : dir) {
+            if (entry.is_directory()) {
+                auto known = std::ranges::find(m_watches, entry.path(), &watch_t::dir);
+
+                if (known == m_watches.end()) {
+                    m_watches.push_back(watch_t { .mod = watch.mod, .root = watch.root, .dir = entry.path() });
+                }
+
+                continue;
+            }
+
+            auto key = entry.path().string();
+            const auto time = entry.last_write_time();
+
+            seen.insert(key);
+
+            auto [it, inserted] = m_stamps.try_emplace(key, stamp_t { time, i });
+
+            if (inserted || it->second.time != time) {
+                it->second.time = time;
+                changes.add(watch.mod, watch.root, entry.path());
+            }
+        }
+    }
+
+
+    std::vector<std::string> removed;
+    for (const auto& [key, stamp] : m_stamps) {
+        if (!seen.contains(key))
+            removed.push_back(key);
+    }
+
+    for (const auto& key : removed) {
+        const auto& watch = m_watches[m_stamps.at(key).watch];
+        changes.add(watch.mod, watch.root, key);
+        m_stamps.erase(key);
+    }
+
+    return changes.take();
+}
+
+#endif
+
+
+// Hot reload
+
+aengine::impl::reload_plan_t aengine::impl::apply_mod_changes(
+    const ModContainer& mods,
+    std::span<const mod_change_t> changes,
+    const std::function<bool(std::string_view)>& stage_filter,
+    std::span<const std::string> mods_order,
+    std::span<const std::string> phases_order
+) {
+    reload_plan_t plan;
+    std::vector<std::pair<const Mod*, std::vector<std::string>>> reloaded;
+
+    for (const auto& change : changes) {
+        auto mod_it = mods.find(change.mod);
+
+        if (change.reinit || mod_it == mods.end()) {
+            plan.reinit.push_back(change.mod);
+            continue;
+        }
+
+        reloaded.emplace_back(&*mod_it, mod_it->reload_files(change.files, stage_filter));
+    }
+
+
+    // Stage infos are viewed only once every reload is done, a later one may move them.
+    // Not ordered mods and phases never ran, "order_stages" drops them as there's nothing to run again.
+    std::vector<stage_ref_t> stages;
+
+    for (const auto& [mod, names] : reloaded) {
+        const auto& infos = mod->content().stage_infos;
+
+        for (const auto& name : names) {
+            auto info_it = infos.find(name);
+
+            if (info_it != infos.end())
+                stages.push_back(stage_ref_t { .mod = mod->name(), .phase = info_it->second.phase, .index = info_it->second.index });
+        }
+    }
+
+    plan.stages = order_stages(stages, mods_order, phases_order);
+
+    return plan;
+}
@@ -0,0 +1,134 @@
+#include "erslib/aengine/resource_cache.hpp"
+
+// std
+#include <mutex>
+
+
+size_t aengine::impl::ResourceCache::usage() const {
+    std::shared_lock lock(m_mutex);
+    return m_usage;
+}
+
+size_t aengine::impl::ResourceCache::size() const {
+    std::shared_lock lock(m_mutex);
+    return m_entries.size();
+}
+
+
+size_t aengine::impl::ResourceCache::trim(size_t budget) {
+    std::vector<std::shared_ptr<const void>> evicted;
+    size_t freed;
+
+    {
+        std::unique_lock lock(m_mutex);
+        freed = _trim(budget, evicted);
+    }
+
+    return freed;
+}
+
+void aengine::impl::ResourceCache::set_budget(size_t budget) {
+    m_budget.store(budget, std::memory_order_relaxed);
+    trim(budget);
+}
+
+void aengine::impl::ResourceCache::erase(std::string_view key) {
+    std::shared_ptr<const void> evicted;
+
+    {
+        std::unique_lock lock(m_mutex);
+
+        if (auto it = m_index.find(key); it != m_index.end())
+            evicted = _remove(it->second);
+    }
+}
+
+void aengine::impl::ResourceCache::clear() {
+    std::vector<std::unique_ptr<entry_t>> evicted;
+
+    {
+        std::unique_lock lock(m_mutex);
+
+        evicted.swap(m_entries);
+        m_index.clear();
+        m_hand = 0;
+        m_usage = 0;
+    }
+}
+
+
+void aengine::impl::ResourceCache::_insert(
+    std::string_view key,
+    std::shared_ptr<const void> handle,
+    use_count_fn use_count,
+    size_t bytes
+) {
+    std::vector<std::shared_ptr<const void>> evicted;
+
+    {
+        std::unique_lock lock(m_mutex);
+
+        // Someone else could have cached it between the shared and the unique lock.
+        if (auto it = m_index.find(key); it != m_index.end()) {
+            m_entries[it->second]->referenced.store(true, std::memory_order_relaxed);
+            return;
+        }
+
+        m_index.emplace(std::string(key), m_entries.size());
+        m_entries.emplace_back(new entry_t {
+            .key       = std::string(key),
+            .handle    = std::move(handle),
+            .use_count = use_count,
+            .bytes     = bytes
+        });
+        m_usage += bytes;
+
+        _trim(budget(), evicted);
+    }
+
+    // Unloading happens here, outside of the lock.
+}
+
+
+size_t aengine::impl::ResourceCache::_trim(size_t budget, std::vector<std::shared_ptr<const void>>& out) {
+    size_t freed = 0;
+
+    // Two full turns are enough: the first one clears every referenced bit.
+    for (size_t steps = 2 * m_entries.size(); m_usage > budget && steps && !m_entries.empty(); steps--) {
+        if (m_hand >= m_entries.size())
+            m_hand = 0;
+
+        auto& entry = *m_entries[m_hand];
+
+        if (entry.use_count(entry.handle.get()) > 1) {
+            m_hand++;
+            continue;
+        }
+
+        if (entry.referenced.exchange(false, std::memory_order_relaxed)) {
+            m_hand++;
+            continue;
+        }
+
+        freed += entry.bytes;
+        out.push_back(_remove(m_hand));
+    }
+
+    return freed;
+}
+
+std::shared_ptr<const void> aengine::impl::ResourceCache::_remove(size_t index) {
+    auto entry = std::move(m_entries[index]);
+
+    // The last entry takes the freed slot, so the hand looks at it next.
+    if (index + 1 != m_entries.size()) {
+        m_entries[index] = std::move(m_entries.back());
+        m_index[m_entries[index]->key] = index;
+    }
+
+    m_entries.pop_back();
+    m_index.erase(entry->key);
+    m_usage -= entry->bytes;
+
+    return std::move(entry->handle);
+}
@@ -0,0 +1,131 @@
+#include "erslib/aengine/setting.hpp"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+// ers
+#include <erslib/core/exception.hpp>
+
+
+namespace {
+    bool is_space(char c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f' || c == '\v';
+    }
+
+    std::string_view trim(std::string_view sv) {
+        while (!sv.empty() && is_space(sv.front()))
+            sv.remove_prefix(1);
+        while (!sv.empty() && is_space(sv.back()))
+            sv.remove_suffix(1);
+
+        return sv;
+    }
+}
+
+
+// BoolSetting
+
+aengine::impl::BoolSetting::BoolSetting(ViewType default_value, ers::optional<Type> forced_value) :
+    BaseSetting(default_value),
+    m_forced_value(forced_value) {
+    reset();
+}
+
+bool aengine::impl::BoolSetting::set(ViewType value) {
+    if (!accepts(value))
+        return false;
+
+    _assign(value);
+    return true;
+}
+
+
+// IntSetting
+
+aengine::impl::IntSetting::IntSetting(ViewType default_value, check_states_t<Type> check_states) :
+    BaseSetting(default_value),
+    m_check_states(std::move(check_states)) {
+    if (!accepts(default_value))
+        throw ers::make_invalid_argument_error("Default value {} doesn't pass its own checks", default_value);
+}
+
+bool aengine::impl::IntSetting::set(ViewType value) {
+    if (!accepts(value))
+        return false;
+
+    _assign(value);
+    return true;
+}
+
+bool aengine::impl::IntSetting::accepts(ViewType value) const {
+    return std::visit([value](const auto& state) { return check_state_visitor<Type> {}(value, state); }, m_check_states);
+}
+
+
+// DoubleSetting
+
+aengine::impl::DoubleSetting::DoubleSetting(ViewType default_value, check_states_t<Type> check_states) :
+    BaseSetting(default_value),
+    m_check_states(std::move(check_states)) {
+    if (!accepts(default_value))
+        throw ers::make_invalid_argument_error("Default value {} doesn't pass its own checks", default_value);
+}
+
+bool aengine::impl::DoubleSetting::set(ViewType value) {
+    if (!accepts(value))
+        return false;
+
+    _assign(value);
+    return true;
+}
+
+bool aengine::impl::DoubleSetting::accepts(ViewType value) const {
+    if (std::isnan(value))
+        return false;
+
+    return std::visit([value](const auto& state) { return check_state_visitor<Type> {}(value, state); }, m_check_states);
+}
+
+
+// StringSetting
+
+aengine::impl::StringSetting::StringSetting(
+    ViewType default_value,
+    bool allow_blank,
+    bool auto_trim,
+    allowed_values_t<Type> allowed_values
+) :
+    BaseSetting(default_value),
+    m_allow_blank(allow_blank),
+    m_auto_trim(auto_trim),
+    m_allowed_values(std::move(allowed_values)) {
+    if (!accepts(default_value))
+        throw ers::make_invalid_argument_error("Default value '{}' doesn't pass its own checks", default_value);
+
+    m_default_value = _normalize(default_value);
+    m_value = m_default_value;
+}
+
+bool aengine::impl::StringSetting::set(ViewType value) {
+    if (!accepts(value))
+        return false;
+
+    _assign(_normalize(value));
+    return true;
+}
+
+bool aengine::impl::StringSetting::accepts(ViewType value) const {
+    value = _normalize(value);
+
+    if (!m_allow_blank && trim(value).empty())
+        return false;
+
+    // Comparator of the set isn't transparent.
+    return m_allowed_values.empty() || std::ranges::binary_search(m_allowed_values, value, std::less<> {});
+}
+
+std::string_view aengine::impl::StringSetting::_normalize(ViewType value) const {
+    return m_auto_trim ? trim(value) : value;
+}
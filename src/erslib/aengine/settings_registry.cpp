@@ -0,0 +1,349 @@
+#include "erslib/aengine/settings_registry.hpp"
+
+// std
+#include <algorithm>
+#include <type_traits>
+
+
+namespace {
+    aengine::impl::setting_value_t value_of(const aengine::impl::setting_t& setting) {
+        return std::visit([](const auto& it) {
+            using type = typename std::remove_cvref_t<decltype(it)>::Type;
+            return aengine::impl::setting_value_t(std::in_place_type<type>, it.value());
+        }, setting);
+    }
+
+    ers::optional<aengine::impl::setting_value_t> from_json(const aengine::impl::setting_t& setting, const utl::Json& node) {
+        return std::visit([&node](const auto& it) -> ers::optional<aengine::impl::setting_value_t> {
+            using type = typename std::remove_cvref_t<decltype(it)>::Type;
+            using result_type = aengine::impl::setting_value_t;
+
+            if constexpr (std::is_same_v<type, bool>) {
+                if (node.is_bool())
+                    return result_type(std::in_place_type<type>, node.as_bool());
+            } else if constexpr (std::is_same_v<type, i64>) {
+                if (node.is_integral())
+                    return result_type(std::in_place_type<type>, node.as_integral());
+            } else if constexpr (std::is_same_v<type, f64>) {
+                if (node.is_floating())
+                    return result_type(std::in_place_type<type>, node.as_floating());
+                if (node.is_integral())
+                    return result_type(std::in_place_type<type>, static_cast<f64>(node.as_integral()));
+            } else {
+                if (node.is_string())
+                    return result_type(std::in_place_type<type>, node.as_string());
+            }
+
+            return ers::nullopt;
+        }, setting);
+    }
+}
+
+
+// SettingsSnapshot
+
+ers::optional<aengine::impl::SettingsSnapshot::id_type> aengine::impl::SettingsSnapshot::find(std::string_view name) const {
+    auto it = m_ids->find(name);
+    if (it == m_ids->end())
+        return ers::nullopt;
+
+    return it->second;
+}
+
+
+// Constructor
+
+aengine::impl::SettingsRegistry::SettingsRegistry() :
+    m_ids(ers::make_shared<const ers::StringMap<id_type>>()) {
+    _publish();
+}
+
+
+// Modifiers
+
+aengine::impl::SettingsRegistry::id_type aengine::impl::SettingsRegistry::add(std::string name, setting_t setting) {
+    std::lock_guard lock(m_mutex);
+
+    if (m_ids->contains(name))
+        throw ers::make_invalid_argument_error("Setting '{}' is already registered", name);
+
+
+    // Snapshots taken before keep the old map.
+    const id_type id = m_entries.size();
+
+    auto ids = ers::make_shared<ers::StringMap<id_type>>(*m_ids);
+    ids->emplace(name, id);
+    m_ids = std::move(ids);
+
+    m_entries.push_back(entry_t { .name = std::move(name), .setting = std::move(setting), .callbacks = {} });
+
+    _publish();
+
+    return id;
+}
+
+
+bool aengine::impl::SettingsRegistry::set(id_type id, setting_value_t value) {
+    std::vector<notification_t> notifications;
+    ApplyResult result;
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto& entry = _entry(id);
+        result = _apply(entry, value);
+
+        if (result == ApplyResult::Changed) {
+            _publish();
+            notifications.push_back(_notification_of(entry));
+        }
+    }
+
+    _notify(notifications);
+
+    return result != ApplyResult::Rejected;
+}
+
+bool aengine::impl::SettingsRegistry::set(std::string_view name, setting_value_t value) {
+    id_type id;
+
+    {
+        std::lock_guard lock(m_mutex);
+        id = _id_of(name);
+    }
+
+    return set(id, std::move(value));
+}
+
+
+void aengine::impl::SettingsRegistry::reset(id_type id) {
+    std::vector<notification_t> notifications;
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        auto& entry = _entry(id);
+        const auto before = value_of(entry.setting);
+
+        std::visit([](auto& it) { it.reset(); }, entry.setting);
+
+        if (value_of(entry.setting) != before) {
+            _publish();
+            notifications.push_back(_notification_of(entry));
+        }
+    }
+
+    _notify(notifications);
+}
+
+void aengine::impl::SettingsRegistry::reset_all() {
+    std::vector<notification_t> notifications;
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        for (auto& entry : m_entries) {
+            const auto before = value_of(entry.setting);
+
+            std::visit([](auto& it) { it.reset(); }, entry.setting);
+
+            if (value_of(entry.setting) != before)
+                notifications.push_back(_notification_of(entry));
+        }
+
+        if (!notifications.empty())
+            _publish();
+    }
+
+    _notify(notifications);
+}
+
+
+aengine::impl::SettingsRegistry::subscription_id aengine::impl::SettingsRegistry::subscribe(id_type id, callback_fn fn) {
+    std::lock_guard lock(m_mutex);
+
+    const auto subscription = m_next_subscription++;
+    _entry(id).callbacks.emplace_back(subscription, std::move(fn));
+
+    return subscription;
+}
+
+void aengine::impl::SettingsRegistry::unsubscribe(subscription_id subscription) {
+    std::lock_guard lock(m_mutex);
+
+    for (auto& entry : m_entries)
+        std::erase_if(entry.callbacks, [subscription](const auto& it) { return it.first == subscription; });
+}
+
+
+ers::Status aengine::impl::SettingsRegistry::load(const utl::Json& json) {
+    if (!json.is_object())
+        return ers::make_error("Settings should be stored in a json object");
+
+
+    std::vector<notification_t> notifications;
+    std::vector<std::string_view> rejected;
+
+    {
+        std::lock_guard lock(m_mutex);
+
+        for (const auto& [name, node] : json.as_object()) {
+            auto it = m_ids->find(name);
+            if (it == m_ids->end())
+                continue;
+
+            auto& entry = m_entries[it->second];
+            auto value = from_json(entry.setting, node);
+
+            const auto result = value ? _apply(entry, *value) : ApplyResult::Rejected;
+
+            if (result == ApplyResult::Rejected)
+                rejected.push_back(name);
+            else if (result == ApplyResult::Changed)
+                notifications.push_back(_notification_of(entry));
+        }
+
+        // One snapshot for the whole file.
+        if (!notifications.empty())
+            _publish();
+    }
+
+    _notify(notifications);
+
+
+    if (rejected.empty())
+        return ers::ok;
+
+    std::ranges::sort(rejected);
+
+    std::string names;
+    for (auto name : rejected) {
+        if (!names.empty())
+            names += ", ";
+        names += name;
+    }
+
+    return ers::make_error("Values of settings {} are rejected", names);
+}
+
+
+// Observers
+
+utl::Json aengine::impl::SettingsRegistry::save() const {
+    utl::Json json;
+    json = utl::Object {};
+
+    std::lock_guard lock(m_mutex);
+
+    for (const auto& entry : m_entries)
+        std::visit([&json, &entry](const auto& value) { json[entry.name] = value; }, value_of(entry.setting));
+
+    return json;
+}
+
+ers::optional<aengine::impl::SettingsRegistry::id_type> aengine::impl::SettingsRegistry::find(std::string_view name) const {
+    std::lock_guard lock(m_mutex);
+
+    auto it = m_ids->find(name);
+    if (it == m_ids->end())
+        return ers::nullopt;
+
+    return it->second;
+}
+
+ers::shared_ptr<const aengine::impl::SettingsSnapshot> aengine::impl::SettingsRegistry::snapshot() const {
+    return m_snapshot.load(std::memory_order_acquire);
+}
+
+bool aengine::impl::SettingsRegistry::refresh(ers::shared_ptr<const SettingsSnapshot>& cached) const {
+    if (cached && cached->version() == m_version.load(std::memory_order_acquire))
+        return false;
+
+    cached = snapshot();
+    return true;
+}
+
+
+// Details
+
+aengine::impl::SettingsRegistry::id_type aengine::impl::SettingsRegistry::_id_of(std::string_view name) const {
+    auto it = m_ids->find(name);
+    if (it == m_ids->end())
+        throw ers::make_out_of_range_error("Setting '{}' isn't registered", name);
+
+    return it->second;
+}
+
+aengine::impl::SettingsRegistry::entry_t& aengine::impl::SettingsRegistry::_entry(id_type id) {
+    if (id >= m_entries.size())
+        throw ers::make_out_of_range_error("Setting id {} isn't registered", id);
+
+    return m_entries[id];
+}
+
+aengine::impl::SettingsRegistry::ApplyResult aengine::impl::SettingsRegistry::_apply(entry_t& entry, const setting_value_t& value) {
+    return std::visit([&value](auto& setting) {
+        using type = typename std::remove_cvref_t<decltype(setting)>::Type;
+
+        const auto* typed = std::get_if<type>(&value);
+
+        // Integral values are taken for doubles, the same way "load" takes them.
+        [[maybe_unused]] type promoted {};
+
+        if constexpr (std::is_same_v<type, f64>) {
+            if (const auto* integral = std::get_if<i64>(&value); integral && !typed) {
+                promoted = static_cast<f64>(*integral);
+                typed = &promoted;
+            }
+        }
+
+        if (!typed)
+            return ApplyResult::Rejected;
+
+        // Compared after "set", strings can be trimmed by it.
+        const type before(setting.value());
+
+        if (!setting.set(*typed))
+            return ApplyResult::Rejected;
+
+        return setting.value() == before ? ApplyResult::Unchanged : ApplyResult::Changed;
+    }, entry.setting);
+}
+
+aengine::impl::SettingsRegistry::notification_t aengine::impl::SettingsRegistry::_notification_of(const entry_t& entry) {
+    notification_t result {
+        .name      = entry.name,
+        .value     = value_of(entry.setting),
+        .callbacks = {}
+    };
+
+    result.callbacks.reserve(entry.callbacks.size());
+    for (const auto& [_, fn] : entry.callbacks)
+        result.callbacks.push_back(fn);
+
+    return result;
+}
+
+void aengine::impl::SettingsRegistry::_publish() {
+    auto snapshot = ers::make_shared<SettingsSnapshot>();
+
+    snapshot->m_ids = m_ids;
+    snapshot->m_values.reserve(m_entries.size());
+
+    for (const auto& entry : m_entries)
+        snapshot->m_values.push_back(value_of(entry.setting));
+
+    const u64 version = m_version.load(std::memory_order_relaxed) + 1;
+    snapshot->m_version = version;
+
+    // Stored before the version, so "refresh" never pins a snapshot older than the version it saw.
+    m_snapshot.store(std::move(snapshot), std::memory_order_release);
+    m_version.store(version, std::memory_order_release);
+}
+
+void aengine::impl::SettingsRegistry::_notify(const std::vector<notification_t>& notifications) {
+    for (const auto& notification : notifications) {
+        for (const auto& fn : notification.callbacks)
+            fn(notification.name, notification.value);
+    }
+}
@@ -0,0 +1,203 @@
+#include "erslib/aengine/util/sandbox.hpp"
+
+// std
+#include <vector>
+
+
+namespace {
+    constexpr auto sandbox_key = "aengine.sandbox";
+    constexpr auto snapshot_key = "aengine.sandbox.snapshot";
+
+    constexpr auto unsafe_fields = { "dofile", "loadfile", "load", "loadstring", "io", "os" };
+
+    // "getfenv(0)" and "getfenv(print)" would hand out the real globals along with every unsafe field,
+    // the sandbox is returned instead. Levels are shifted past the wrapper itself.
+    constexpr auto getfenv_wrapper = R"(
+        local getfenv, type, globals, sandbox = ...
+
+        return function(f)
+            if f == nil then
+                f = 1
+            end
+
+            if type(f) == "number" and f > 0 then
+                f = f + 1
+            end
+
+            local env = getfenv(f)
+
+            if env == globals then
+                return sandbox
+            end
+
+            return env
+        end
+    )";
+
+
+    sol::table shallow_copy(sol::state_view& lua, const sol::table& from) {
+        sol::table result = lua.create_table();
+
+        for (const auto& [key, value] : from)
+            result.raw_set(key, value);
+
+        return result;
+    }
+
+    void restore_table(sol::table& target, const sol::table& snapshot) {
+        std::vector<sol::object> added;
+
+        for (const auto& [key, value] : target) {
+            if (snapshot.raw_get<sol::object>(key).get_type() == sol::type::lua_nil)
+                added.push_back(key);
+        }
+
+        for (const auto& key : added)
+            target.raw_set(key, sol::lua_nil);
+
+        for (const auto& [key, value] : snapshot)
+            target.raw_set(key, value);
+    }
+
+
+    // Missing metatables are kept as 'false', nil can't be stored in a table.
+    sol::object get_metatable(lua_State* L, const sol::object& object) {
+        object.push(L);
+
+        if (!lua_getmetatable(L, -1)) {
+            lua_pop(L, 1);
+            return sol::make_object(L, false);
+        }
+
+        sol::object result(L, -1);
+        lua_pop(L, 2);
+
+        return result;
+    }
+
+    // Goes around "__metatable", so a protected metatable is replaced as well.
+    void set_metatable(lua_State* L, const sol::object& object, const sol::object& metatable) {
+        object.push(L);
+
+        if (metatable.is<sol::table>())
+            metatable.push(L);
+        else
+            lua_pushnil(L);
+
+        lua_setmetatable(L, -2);
+        lua_pop(L, 1);
+    }
+}
+
+
+sol::table aengine::impl::util::sandbox_globals(sol::state_view lua) {
+    if (sol::object cached = lua.registry()[sandbox_key]; cached.is<sol::table>())
+        return cached.as<sol::table>();
+
+
+    lua_State* L = lua.lua_state();
+    sol::table globals = lua.globals();
+    sol::table sandbox = shallow_copy(lua, globals);
+
+    for (const auto& it : unsafe_fields)
+        sandbox.raw_set(it, sol::lua_nil);
+
+    // Otherwise "_G.io" reaches the real globals.
+    sandbox.raw_set("_G", sandbox);
+
+    if (sol::object getfenv = globals.raw_get<sol::object>("getfenv"); getfenv.is<sol::function>()) {
+        sol::protected_function make_wrapper = lua.load(getfenv_wrapper, "=aengine.sandbox");
+        sandbox.raw_set("getfenv", make_wrapper(getfenv, globals.raw_get<sol::object>("type"), globals, sandbox).get<sol::object>());
+    }
+
+
+    // Libraries are snapshotted one level deep, that's where mods can leak changes to each other.
+    // Metatables are kept for every snapshotted table, "setmetatable(_G, ...)" is just as visible.
+    sol::table snapshot = lua.create_table();
+    sol::table libraries = lua.create_table();
+    sol::table metatables = lua.create_table();
+
+    for (const auto& [key, value] : sandbox) {
+        if (value.is<sol::table>() && value != sandbox) {
+            libraries.raw_set(key, shallow_copy(lua, value.as<sol::table>()));
+            metatables.raw_set(value, get_metatable(L, value));
+        }
+    }
+
+    metatables.raw_set(sandbox, get_metatable(L, sandbox));
+    metatables.raw_set(globals, get_metatable(L, globals));
+
+
+    // Every string shares one metatable, its "__index" is the string library.
+    const auto any_string = sol::make_object(L, "");
+    const auto string_metatable = get_metatable(L, any_string);
+
+    snapshot.raw_set("string_metatable", string_metatable);
+
+    if (string_metatable.is<sol::table>())
+        snapshot.raw_set("string_metatable_fields", shallow_copy(lua, string_metatable.as<sol::table>()));
+
+
+    snapshot.raw_set("globals", shallow_copy(lua, sandbox));
+    snapshot.raw_set("libraries", libraries);
+    snapshot.raw_set("metatables", metatables);
+    snapshot.raw_set("state_globals", globals);
+    snapshot.raw_set("state_globals_fields", shallow_copy(lua, globals));
+
+
+    lua.registry()[sandbox_key] = sandbox;
+    lua.registry()[snapshot_key] = snapshot;
+
+    return sandbox;
+}
+
+void aengine::impl::util::restore_sandbox(sol::state_view lua) {
+    sol::object stored = lua.registry()[snapshot_key];
+    if (!stored.is<sol::table>())
+        return;
+
+    lua_State* L = lua.lua_state();
+    sol::table snapshot = stored.as<sol::table>();
+
+
+    // "setfenv(0, ...)" swaps the globals of the main thread, chunks loaded later would run in them.
+    sol::table state_globals = snapshot["state_globals"];
+    sol::table state_globals_fields = snapshot["state_globals_fields"];
+
+#if LUA_VERSION_NUM == 501
+    state_globals.push(L);
+    lua_replace(L, LUA_GLOBALSINDEX);
+#endif
+
+    restore_table(state_globals, state_globals_fields);
+
+
+    sol::table sandbox = lua.registry()[sandbox_key];
+    sol::table globals = snapshot["globals"];
+    sol::table libraries = snapshot["libraries"];
+
+    restore_table(sandbox, globals);
+
+    for (const auto& [key, value] : libraries) {
+        sol::table library = globals.raw_get<sol::table>(key);
+        restore_table(library, value.as<sol::table>());
+    }
+
+
+    sol::table metatables = snapshot["metatables"];
+
+    for (const auto& [table, metatable] : metatables)
+        set_metatable(L, table, metatable);
+
+
+    const auto any_string = sol::make_object(L, "");
+    const sol::object string_metatable = snapshot["string_metatable"];
+
+    set_metatable(L, any_string, string_metatable);
+
+    if (string_metatable.is<sol::table>()) {
+        sol::table fields = snapshot["string_metatable_fields"];
+        sol::table target = string_metatable.as<sol::table>();
+        restore_table(target, fields);
+    }
+}
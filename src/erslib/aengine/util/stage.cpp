@@ -1,32 +1,72 @@
 #include "erslib/aengine/util/stage.hpp"
 
-// boost
-#include <boost/regex.hpp>
+// std
+#include <algorithm>
+#include <format>
+#include <utility>
 
 // ers
 #include <erslib/core/convert/string.hpp>
 
 
 namespace {
-    constexpr auto stage_name_pattern = R"((.+)-(\d+))";
+    // '<phase>-<digits>' split at the last '-', digits aren't checked for leading zeros.
+    ers::optional<std::pair<std::string_view, std::string_view>> split_stage_name(std::string_view sv) {
+        const size_t dash = sv.rfind('-');
+
+        if (dash == std::string_view::npos || dash == 0 || dash + 1 == sv.size())
+            return ers::nullopt;
+
+
+        auto digits = sv.substr(dash + 1);
+
+        if (!std::ranges::all_of(digits, [](char c) { return c >= '0' && c <= '9'; }))
+            return ers::nullopt;
+
+        return std::pair { sv.substr(0, dash), digits };
+    }
 }
 
 
-bool aengine::impl::util::is_stage_naming_scheme(std::string_view sv) {
-    boost::regex regex(stage_name_pattern);
-    return boost::regex_match(sv.begin(), sv.end(), regex);
+ers::optional<aengine::impl::util::stage_name_t> aengine::impl::util::parse_stage_name(std::string_view sv) {
+    auto split = split_stage_name(sv);
+    if (!split)
+        return ers::nullopt;
+
+    auto [phase, digits] = *split;
+
+    // Otherwise "data-01" and "data-1" would be one stage and "make_stage_name" couldn't give the name back.
+    if (digits.size() > 1 && digits.front() == '0')
+        return ers::nullopt;
+
+    auto r = ers::convert::from_str<size_t>(digits);
+    if (!r)
+        return ers::nullopt;
+
+
+    return stage_name_t {
+        .phase = phase,
+        .index = *r
+    };
 }
 
-std::tuple<std::string, size_t> aengine::impl::util::extract_stage_info(std::string_view sv) {
-    boost::regex regex(stage_name_pattern);
-    boost::match_results<std::string_view::const_iterator> match;
+bool aengine::impl::util::has_padded_stage_index(std::string_view sv) {
+    auto split = split_stage_name(sv);
+    return split && split->second.size() > 1 && split->second.front() == '0';
+}
 
-    if (!boost::regex_match(sv.begin(), sv.end(), match, regex) || match.size() != 3)
-        return {};
+bool aengine::impl::util::is_stage_naming_scheme(std::string_view sv) {
+    return parse_stage_name(sv).has_value();
+}
 
-    auto r = ers::convert::from_str<size_t>(match[2].str());
+std::tuple<std::string, size_t> aengine::impl::util::extract_stage_info(std::string_view sv) {
+    auto r = parse_stage_name(sv);
     if (!r)
         return {};
 
-    return { match[1], *r };
+    return { std::string(r->phase), r->index };
+}
+
+std::string aengine::impl::util::make_stage_name(std::string_view phase, size_t index) {
+    return std::format("{}-{}", phase, index);
 }
@@ -2,6 +2,7 @@
 
 // std
 #include <algorithm>
+#include <ranges>
 
 // ers
 #include <erslib/aescript/impl/context.hpp>
@@ -79,10 +80,13 @@ void aescript::impl::Field::_copy_from(const Field& other) {
     _verifiers_order.clear();
     _parsers.clear();
 
-    for (const auto& it : other._verifiers)
+    _verifiers_order.reserve(other._verifiers_order.size());
+
+    // "add" prepends, so walk backwards to keep the original order.
+    for (const auto& it : other._verifiers | std::views::reverse)
         add(it);
 
-    for (const auto& it : other._parsers)
+    for (const auto& it : other._parsers | std::views::reverse)
         add(it);
 }
 
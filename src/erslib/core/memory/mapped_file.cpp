@@ -0,0 +1,124 @@
+#include "erslib/core/memory/mapped_file.hpp"
+
+// std
+#include <cerrno>
+#include <cstring>
+#include <utility>
+
+// ers
+#include <erslib/core/exception/filesystem_error.hpp>
+
+#ifdef _WIN32
+// windows
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+// posix
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+// Constructor
+
+ers::impl::MappedFile::MappedFile(const fs::path& path) {
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        throw make_path_error("Can't open file '{}' for mapping", path.string());
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        throw make_path_error("Can't get size of file '{}'", path.string());
+    }
+
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return;
+    }
+
+    // The view keeps the file open, both handles can be closed right away.
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+
+    if (!mapping)
+        throw make_path_error("Can't map file '{}'", path.string());
+
+    void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+
+    if (!data)
+        throw make_path_error("Can't map file '{}'", path.string());
+
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(size.QuadPart);
+#else
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        throw make_path_error("Can't open file '{}' for mapping: {}", path.string(), std::strerror(errno));
+
+    struct stat info {};
+    if (fstat(fd, &info) != 0) {
+        const int error = errno;
+        close(fd);
+        throw make_path_error("Can't get size of file '{}': {}", path.string(), std::strerror(error));
+    }
+
+    if (info.st_size == 0) {
+        close(fd);
+        return;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    const int error = errno;
+    close(fd);
+
+    if (data == MAP_FAILED)
+        throw make_path_error("Can't map file '{}': {}", path.string(), std::strerror(error));
+
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<size_t>(info.st_size);
+#endif
+}
+
+ers::impl::MappedFile::MappedFile(MappedFile&& other) noexcept :
+    m_data(std::exchange(other.m_data, nullptr)),
+    m_size(std::exchange(other.m_size, 0)) {
+}
+
+ers::impl::MappedFile& ers::impl::MappedFile::operator=(MappedFile&& other) noexcept {
+    if (this != &other) {
+        _unmap();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+
+    return *this;
+}
+
+
+// Destructor
+
+ers::impl::MappedFile::~MappedFile() {
+    _unmap();
+}
+
+
+// Details
+
+void ers::impl::MappedFile::_unmap() noexcept {
+    if (!m_data)
+        return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<char*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
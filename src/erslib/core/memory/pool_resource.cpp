@@ -0,0 +1,172 @@
+#include "erslib/core/memory/pool_resource.hpp"
+
+// std
+#include <mutex>
+
+
+namespace {
+    using resource_type = ers::impl::SizeClassResource;
+
+    constexpr size_t bin_count = resource_type::bin_sizes.size();
+
+    // Above this a thread gives a slab worth of blocks back to the shared list.
+    constexpr size_t cache_limit = 2 * resource_type::blocks_per_slab;
+
+
+    struct block_t {
+        block_t* next;
+    };
+
+    struct free_list_t {
+        block_t* head = nullptr;
+        size_t count = 0;
+
+
+        void push(void* p) {
+            auto block = static_cast<block_t*>(p);
+            block->next = head;
+            head = block;
+            count++;
+        }
+
+        void* pop() {
+            block_t* block = head;
+            head = block->next;
+            count--;
+            return block;
+        }
+
+        // Moves up to "n" blocks from "other" into this list.
+        void take(free_list_t& other, size_t n) {
+            while (n-- && other.head)
+                push(other.pop());
+        }
+    };
+
+    using bins_type = std::array<free_list_t, bin_count>;
+
+
+    // Blocks given back by exiting threads and by threads that free more than they allocate.
+    struct shared_state_t {
+        std::mutex mutex;
+        bins_type spare;
+    };
+
+    shared_state_t& shared_state() {
+        static shared_state_t state;
+        return state;
+    }
+
+
+    // Trivially destructible, so objects destroyed after the thread's cache was flushed still can
+    // free into it safely, "t_flushed" makes them go to the shared list instead.
+    thread_local bins_type t_bins;
+    thread_local bool t_flushed = false;
+
+    // Hands the thread's blocks to the shared list when the thread exits.
+    struct flush_guard_t {
+        ~flush_guard_t() {
+            auto& shared = shared_state();
+            std::scoped_lock lock(shared.mutex);
+
+            for (size_t bin = 0; bin < bin_count; bin++)
+                shared.spare[bin].take(t_bins[bin], t_bins[bin].count);
+
+            t_flushed = true;
+        }
+    };
+
+    thread_local flush_guard_t t_guard;
+
+    // Odr-uses the guard, so its destructor gets registered for the current thread.
+    void arm_flush_guard() {
+        [[maybe_unused]] volatile auto* guard = &t_guard;
+    }
+
+
+    constexpr size_t bin_of(size_t bytes) {
+        size_t bin = 0;
+        while (resource_type::bin_sizes[bin] < bytes)
+            bin++;
+        return bin;
+    }
+
+    constexpr bool is_pooled(size_t bytes, size_t alignment) {
+        return bytes <= resource_type::max_block_size && alignment <= resource_type::block_align;
+    }
+}
+
+
+resource_type& ers::impl::SizeClassResource::instance() {
+    static SizeClassResource resource(std::pmr::new_delete_resource());
+    return resource;
+}
+
+ers::impl::SizeClassResource::SizeClassResource(std::pmr::memory_resource* upstream) :
+    m_upstream(upstream) {
+}
+
+
+void* ers::impl::SizeClassResource::do_allocate(size_t bytes, size_t alignment) {
+    if (!is_pooled(bytes, alignment))
+        return m_upstream->allocate(bytes, alignment);
+
+    const size_t bin = bin_of(bytes);
+    auto& local = t_bins[bin];
+
+    if (local.head)
+        return local.pop();
+
+
+    // Slow path: refill from the shared list or carve a new slab.
+    auto& shared = shared_state();
+    std::scoped_lock lock(shared.mutex);
+
+    if (t_flushed) {
+        if (shared.spare[bin].head)
+            return shared.spare[bin].pop();
+
+        return m_upstream->allocate(bin_sizes[bin], block_align);
+    }
+
+    arm_flush_guard();
+
+    if (shared.spare[bin].head) {
+        local.take(shared.spare[bin], blocks_per_slab);
+    } else {
+        const size_t block_size = bin_sizes[bin];
+        auto slab = static_cast<std::byte*>(m_upstream->allocate(block_size * blocks_per_slab, block_align));
+
+        for (size_t i = blocks_per_slab; i-- > 0;)
+            local.push(slab + i * block_size);
+    }
+
+    return local.pop();
+}
+
+void ers::impl::SizeClassResource::do_deallocate(void* p, size_t bytes, size_t alignment) {
+    if (!is_pooled(bytes, alignment)) {
+        m_upstream->deallocate(p, bytes, alignment);
+        return;
+    }
+
+    const size_t bin = bin_of(bytes);
+
+    if (t_flushed) {
+        auto& shared = shared_state();
+        std::scoped_lock lock(shared.mutex);
+        shared.spare[bin].push(p);
+        return;
+    }
+
+    arm_flush_guard();
+
+    auto& local = t_bins[bin];
+    local.push(p);
+
+    if (local.count > cache_limit) {
+        auto& shared = shared_state();
+        std::scoped_lock lock(shared.mutex);
+        shared.spare[bin].take(local, blocks_per_slab);
+    }
+}
@@ -0,0 +1,81 @@
+#include "erslib/core/memory/scratch_arena.hpp"
+
+// std
+#include <algorithm>
+#include <cstdint>
+
+
+ers::impl::ScratchArena::ScratchArena(std::pmr::memory_resource* upstream) :
+    m_upstream(upstream) {
+}
+
+ers::impl::ScratchArena::~ScratchArena() {
+    for (const auto& block : m_blocks)
+        m_upstream->deallocate(block.data, block.size, alignof(std::max_align_t));
+}
+
+
+ers::impl::ScratchArena& ers::impl::ScratchArena::local() {
+    thread_local ScratchArena arena;
+    return arena;
+}
+
+
+size_t ers::impl::ScratchArena::used() const noexcept {
+    size_t result = m_offset;
+
+    for (size_t i = 0; i < m_block && i < m_blocks.size(); i++)
+        result += m_blocks[i].size;
+
+    return result;
+}
+
+size_t ers::impl::ScratchArena::capacity() const noexcept {
+    size_t result = 0;
+
+    for (const auto& block : m_blocks)
+        result += block.size;
+
+    return result;
+}
+
+
+void* ers::impl::ScratchArena::do_allocate(size_t bytes, size_t alignment) {
+    while (true) {
+        if (m_block < m_blocks.size()) {
+            const auto& block = m_blocks[m_block];
+
+            const auto base = reinterpret_cast<uintptr_t>(block.data);
+            const size_t aligned = ((base + m_offset + alignment - 1) & ~(alignment - 1)) - base;
+
+            if (aligned + bytes <= block.size) {
+                m_offset = aligned + bytes;
+                return block.data + aligned;
+            }
+
+            // Blocks kept from earlier scopes are tried in order before growing.
+            if (m_block + 1 < m_blocks.size()) {
+                m_block++;
+                m_offset = 0;
+                continue;
+            }
+        }
+
+
+        // Every block is twice as big as the previous one, oversized requests get a block of their own size.
+        const size_t grown = m_blocks.empty() ? initial_block_size : m_blocks.back().size * 2;
+        const size_t size = std::max(grown, bytes + alignment);
+
+        auto data = static_cast<std::byte*>(m_upstream->allocate(size, alignof(std::max_align_t)));
+        m_blocks.push_back({ .data = data, .size = size });
+
+        m_block = m_blocks.size() - 1;
+        m_offset = 0;
+    }
+}
+
+
+void ers::impl::ScratchArena::_rewind(size_t block, size_t offset) noexcept {
+    m_block = block;
+    m_offset = offset;
+}
@@ -0,0 +1,91 @@
+#include "erslib/core/thread_safe/worker_pool.hpp"
+
+// std
+#include <algorithm>
+
+
+ers::impl::thread_safe::WorkerPool::WorkerPool(size_t threads) {
+    m_workers.reserve(threads);
+
+    for (size_t i = 0; i < std::max<size_t>(threads, 1); i++)
+        m_workers.emplace_back([this](std::stop_token stop) { _run(std::move(stop)); });
+}
+
+ers::impl::thread_safe::WorkerPool::~WorkerPool() {
+    {
+        std::scoped_lock lock(m_mutex);
+
+        for (auto& task : m_queue)
+            task.stop.request_stop();
+    }
+
+    // Workers drain what is left and exit once "m_workers" joins them.
+}
+
+
+std::stop_source ers::impl::thread_safe::WorkerPool::post(task_fn fn, TaskPriority priority) {
+    std::stop_source stop;
+
+    {
+        std::scoped_lock lock(m_mutex);
+
+        m_queue.push_back(task_t {
+            .priority = priority,
+            .sequence = m_sequence++,
+            .stop     = stop,
+            .fn       = std::move(fn)
+        });
+        std::ranges::push_heap(m_queue, _before);
+    }
+
+    m_ready.notify_one();
+    return stop;
+}
+
+void ers::impl::thread_safe::WorkerPool::wait_idle() {
+    std::unique_lock lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_queue.empty() && m_active == 0; });
+}
+
+
+size_t ers::impl::thread_safe::WorkerPool::default_threads() noexcept {
+    return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+}
+
+
+void ers::impl::thread_safe::WorkerPool::_run(std::stop_token stop) {
+    while (true) {
+        task_t task;
+
+        {
+            std::unique_lock lock(m_mutex);
+
+            if (!m_ready.wait(lock, stop, [this] { return !m_queue.empty(); }))
+                return;
+
+            std::ranges::pop_heap(m_queue, _before);
+            task = std::move(m_queue.back());
+            m_queue.pop_back();
+
+            m_active++;
+        }
+
+        task.fn(task.stop.get_token());
+
+        {
+            std::scoped_lock lock(m_mutex);
+            m_active--;
+
+            if (m_queue.empty() && m_active == 0)
+                m_idle.notify_all();
+        }
+    }
+}
+
+// Heap order: the top is the highest priority, then the earliest submitted.
+bool ers::impl::thread_safe::WorkerPool::_before(const task_t& lhs, const task_t& rhs) noexcept {
+    if (lhs.priority != rhs.priority)
+        return lhs.priority < rhs.priority;
+
+    return lhs.sequence > rhs.sequence;
+}
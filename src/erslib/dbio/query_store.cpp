@@ -4,6 +4,9 @@
 #include <fstream>
 #include <mutex>
 #include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 
 namespace fs = std::filesystem;
@@ -47,17 +50,20 @@ size_t dbio::impl::QueryStore::load_directory(const fs::path& root) {
     if (!fs::is_directory(root))
         return 0;
 
-    size_t count = 0;
+    // Files are read without holding the lock, then inserted in a single batch.
+    std::vector<std::pair<std::string, std::string>> items;
 
     for (const auto& entry : fs::recursive_directory_iterator(root)) {
         if (!entry.is_regular_file() || entry.path().extension() != ".sql")
             continue;
 
         const fs::path relative = fs::relative(entry.path(), root);
-        add(make_label(relative), read_file(entry.path()));
-        count++;
+        items.emplace_back(make_label(relative), read_file(entry.path()));
     }
 
+    const size_t count = items.size();
+    set_many(std::move(items));
+
     return count;
 }
 
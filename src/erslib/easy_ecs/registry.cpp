@@ -12,7 +12,7 @@
 // Tracking
 
 size_t ecs::impl::Registry::track_entity(IEntity& entity) {
-    size_t id = ers::RapidHash<std::string_view> {}(entity.name());
+    size_t id = ers::RapidNanoHash<std::string_view> {}(entity.name());
     m_entities.emplace(id, &entity);
     return id;
 }
@@ -0,0 +1,282 @@
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+// ers
+#include <erslib/contrib/json.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+// Counting allocator
+//
+// Every global allocation in the process goes through these replacements, but only the ones made
+// while 'g_counting' is raised end up in the report. The benchmark is single-threaded, so plain
+// counters are enough.
+
+namespace {
+    bool g_counting = false;
+    size_t g_allocations = 0;
+    size_t g_allocated_bytes = 0;
+
+
+    void* counted_alloc(size_t size, size_t align) {
+        if (g_counting) {
+            g_allocations++;
+            g_allocated_bytes += size;
+        }
+
+        void* ptr = align > alignof(std::max_align_t)
+            ? std::aligned_alloc(align, (size + align - 1) / align * align)
+            : std::malloc(size ? size : 1);
+
+        if (!ptr)
+            throw std::bad_alloc();
+
+        return ptr;
+    }
+}
+
+void* operator new(size_t size) {
+    return counted_alloc(size, alignof(std::max_align_t));
+}
+void* operator new(size_t size, std::align_val_t align) {
+    return counted_alloc(size, static_cast<size_t>(align));
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+
+
+// Measurement
+
+namespace {
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr auto min_duration = std::chrono::milliseconds(500);
+    constexpr size_t min_iterations = 5;
+
+
+    struct measurement_t {
+        double best_seconds;
+        double mean_seconds;
+        size_t allocations;
+        size_t allocated_bytes;
+    };
+
+    // Prevents the optimizer from dropping the measured call.
+    volatile size_t g_sink = 0;
+
+
+    template<typename Fn>
+    measurement_t measure(Fn&& fn) {
+        measurement_t result = {};
+
+        // A single counted run: parsing and serializing are deterministic,
+        // so allocations per document don't change between iterations.
+        g_allocations = 0;
+        g_allocated_bytes = 0;
+        g_counting = true;
+        g_sink = g_sink + fn();
+        g_counting = false;
+
+        result.allocations = g_allocations;
+        result.allocated_bytes = g_allocated_bytes;
+
+
+        double total = 0;
+        size_t iterations = 0;
+        result.best_seconds = std::numeric_limits<double>::max();
+
+        const auto deadline = clock_type::now() + min_duration;
+        while (iterations < min_iterations || clock_type::now() < deadline) {
+            const auto start = clock_type::now();
+            g_sink = g_sink + fn();
+            const std::chrono::duration<double> elapsed = clock_type::now() - start;
+
+            result.best_seconds = std::min(result.best_seconds, elapsed.count());
+            total += elapsed.count();
+            iterations++;
+        }
+
+        result.mean_seconds = total / static_cast<double>(iterations);
+
+
+        return result;
+    }
+
+    void report(std::string_view corpus, std::string_view operation, size_t bytes, const measurement_t& m) {
+        constexpr double mb = 1024.0 * 1024.0;
+
+        std::println("{:<20} {:<22} {:>10.2f} {:>10.2f} {:>12} {:>14}",
+            corpus,
+            operation,
+            static_cast<double>(bytes) / mb / m.best_seconds,
+            static_cast<double>(bytes) / mb / m.mean_seconds,
+            m.allocations,
+            m.allocated_bytes
+        );
+    }
+}
+
+
+// Corpora
+
+namespace {
+    struct corpus_t {
+        std::string name;
+        fs::path path;
+        std::string chars;
+    };
+
+
+    // Mostly long strings with escapes and non-ASCII characters, close to what chat logs or
+    // localization tables look like.
+    std::string generate_string_heavy(size_t records) {
+        std::mt19937_64 rng(0x5eed);
+        std::uniform_int_distribution<int> length(16, 256);
+        std::uniform_int_distribution<int> letter('a', 'z');
+        std::uniform_int_distribution<int> special(0, 31);
+
+        std::string result = "[";
+
+        for (size_t i = 0; i < records; i++) {
+            if (i)
+                result += ',';
+
+            result += std::format(R"({{"id":"record-{}","text":")", i);
+
+            const int n = length(rng);
+            for (int j = 0; j < n; j++) {
+                switch (special(rng)) {
+                    case 0: result += "\\n"; break;
+                    case 1: result += "\\\""; break;
+                    case 2: result += "\\u00e9"; break;
+                    case 3: result += "\xd0\x96"; break;
+                    default: result += static_cast<char>(letter(rng));
+                }
+            }
+
+            result += R"(","tags":["alpha","beta","gamma"]})";
+        }
+
+        result += ']';
+
+        return result;
+    }
+
+    // Coordinate-like arrays of floats and counters, close to what canada.json stresses.
+    std::string generate_number_heavy(size_t records) {
+        std::mt19937_64 rng(0x5eed);
+        std::uniform_real_distribution<double> coord(-180.0, 180.0);
+        std::uniform_int_distribution<i64> counter(-1'000'000'000, 1'000'000'000);
+
+        std::string result = "[";
+
+        for (size_t i = 0; i < records; i++) {
+            if (i)
+                result += ',';
+
+            result += std::format("[{:.15g},{:.15g},{},{}]", coord(rng), coord(rng), counter(rng), i);
+        }
+
+        result += ']';
+
+        return result;
+    }
+
+
+    std::vector<corpus_t> load_corpora() {
+        std::vector<corpus_t> result;
+
+        const fs::path corpus_dir = BENCH_CORPUS_DIR;
+
+        for (auto name : { "twitter.json", "canada.json", "citm_catalog.json" }) {
+            const auto path = corpus_dir / name;
+
+            if (!fs::exists(path)) {
+                std::println(stderr, "skipping '{}': not found in '{}'", name, corpus_dir.string());
+                continue;
+            }
+
+            std::ifstream file(path, std::ios::binary);
+            std::string chars { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+            result.push_back({ .name = name, .path = path, .chars = std::move(chars) });
+        }
+
+
+        // Generated corpora are written next to the binary so 'from_file' can be measured on them too.
+
+        auto add_generated = [&result](std::string name, std::string chars) {
+            const fs::path path = fs::path(BENCH_CWD) / name;
+            std::ofstream(path, std::ios::binary) << chars;
+
+            result.push_back({ .name = std::move(name), .path = path, .chars = std::move(chars) });
+        };
+
+        add_generated("string_heavy.json", generate_string_heavy(20'000));
+        add_generated("number_heavy.json", generate_number_heavy(100'000));
+
+
+        return result;
+    }
+}
+
+
+int main() {
+    const auto corpora = load_corpora();
+
+    std::println("{:<20} {:<22} {:>10} {:>10} {:>12} {:>14}",
+        "corpus", "operation", "best MB/s", "mean MB/s", "allocs/doc", "bytes/doc");
+
+
+    for (const auto& corpus : corpora) {
+        const auto node = utl::from_string(corpus.chars);
+
+        const auto pretty = node.to_string(utl::Format::Pretty);
+        const auto minimized = node.to_string(utl::Format::Minimized);
+
+
+        report(corpus.name, "from_string", corpus.chars.size(), measure([&] {
+            return static_cast<size_t>(utl::from_string(corpus.chars).type());
+        }));
+
+        report(corpus.name, "from_file", corpus.chars.size(), measure([&] {
+            return static_cast<size_t>(utl::from_file(corpus.path).type());
+        }));
+
+        report(corpus.name, "to_string(Pretty)", pretty.size(), measure([&] {
+            return node.to_string(utl::Format::Pretty).size();
+        }));
+
+        report(corpus.name, "to_string(Minimized)", minimized.size(), measure([&] {
+            return node.to_string(utl::Format::Minimized).size();
+        }));
+    }
+
+
+    return 0;
+}
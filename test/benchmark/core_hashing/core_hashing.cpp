@@ -0,0 +1,88 @@
+// std
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <limits>
+#include <print>
+#include <random>
+#include <string>
+#include <vector>
+
+// ers
+#include <erslib/core/hashing/rapid.hpp>
+
+
+// Prints ns per hash of every rapidhash variant for growing key sizes,
+// the smallest value in a row is where that variant wins.
+
+namespace {
+    using clock_type = std::chrono::steady_clock;
+
+    constexpr size_t keys_per_size = 1024;
+    constexpr size_t rounds = 200;
+
+    constexpr std::array key_sizes = {
+        4uz, 8uz, 12uz, 16uz, 24uz, 32uz, 48uz, 64uz, 80uz, 96uz, 112uz, 128uz,
+        192uz, 256uz, 512uz, 1024uz, 4096uz, 16384uz, 65536uz,
+    };
+
+
+    // Prevents the optimizer from dropping the measured call.
+    volatile size_t g_sink = 0;
+
+
+    std::vector<std::string> make_keys(size_t size) {
+        std::mt19937_64 rng(size);
+        std::uniform_int_distribution<int> byte(0, 255);
+
+        std::vector<std::string> result(keys_per_size);
+
+        for (auto& key : result) {
+            key.resize(size);
+            for (auto& c : key)
+                c = static_cast<char>(byte(rng));
+        }
+
+        return result;
+    }
+
+    template<template<typename> typename Hash>
+    double ns_per_hash(const std::vector<std::string>& keys) {
+        const auto total_rounds = std::max<size_t>(1, rounds * 64 / std::max<size_t>(keys.front().size(), 64));
+        double best = std::numeric_limits<double>::max();
+
+        for (size_t r = 0; r < total_rounds; r++) {
+            size_t acc = 0;
+
+            const auto start = clock_type::now();
+            for (const auto& key : keys)
+                acc ^= Hash<std::string> {}(key, acc);
+            const std::chrono::duration<double, std::nano> elapsed = clock_type::now() - start;
+
+            g_sink = g_sink + acc;
+            best = std::min(best, elapsed.count() / static_cast<double>(keys.size()));
+        }
+
+        return best;
+    }
+}
+
+
+int main() {
+    std::println("{:>8} {:>10} {:>10} {:>10} {:>10}", "bytes", "nano", "micro", "full", "unrolled");
+
+    for (auto size : key_sizes) {
+        const auto keys = make_keys(size);
+
+        std::println("{:>8} {:>10.2f} {:>10.2f} {:>10.2f} {:>10.2f}",
+            size,
+            ns_per_hash<ers::RapidNanoHash>(keys),
+            ns_per_hash<ers::RapidHash>(keys),
+            ns_per_hash<ers::RapidFullHash>(keys),
+            ns_per_hash<ers::RapidUnrolledHash>(keys)
+        );
+    }
+
+
+    return 0;
+}
@@ -0,0 +1,185 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// sol
+#include <sol/sol.hpp>
+
+// ers
+#include <erslib/aengine/bytecode_cache.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+namespace {
+    // Offset of "size" in the header of a cached file, the bytecode follows the header.
+    constexpr size_t size_offset = 48;
+    constexpr size_t header_size = 56;
+
+
+    std::string read_binary(const fs::path& path) {
+        std::ifstream stream(path, std::ios::binary);
+        return { std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>() };
+    }
+
+    void write_binary(const fs::path& path, std::string_view data) {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(data.data(), static_cast<std::streamsize>(data.size()));
+    }
+
+    std::vector<fs::path> cached_files(const fs::path& dir) {
+        std::vector<fs::path> result;
+
+        for (const auto& it : fs::directory_iterator(dir)) {
+            if (it.path().extension() == ".luac")
+                result.push_back(it.path());
+        }
+
+        return result;
+    }
+
+    int run(sol::load_result result) {
+        REQUIRE(result.valid());
+
+        sol::protected_function fn = result;
+        return fn().get<int>();
+    }
+
+    // Replaces the bytecode of "target" with the one of "donor", keeping the header of "target".
+    // Whatever the cache serves for "target" then tells whether the file was taken.
+    void transplant_bytecode(const fs::path& target, const fs::path& donor) {
+        auto data = read_binary(target).substr(0, header_size);
+        const auto bytecode = read_binary(donor).substr(header_size);
+
+        const std::uint64_t size = bytecode.size();
+        data.replace(size_offset, sizeof(size), reinterpret_cast<const char*>(&size), sizeof(size));
+
+        write_binary(target, data + bytecode);
+    }
+}
+
+
+TEST_CASE("testing aengine::BytecodeCache") {
+    const auto root = fs::temp_directory_path() / "aengine_bytecode_cache_test";
+    fs::remove_all(root);
+
+    const auto dir = root / "cache";
+
+    const aengine::ModIdentity mod { .name = "m", .title = "m", .version = { 1, 0, 0 } };
+    const aengine::ModIdentity donor { .name = "donor", .title = "donor", .version = { 1, 0, 0 } };
+
+    sol::state lua;
+    sol::state_view view(lua);
+
+
+    SUBCASE("a cold load compiles the source and writes the chunk") {
+        aengine::BytecodeCache cache(dir);
+        CHECK(cache.size() == 0);
+
+        CHECK(run(cache.load(view, mod, "data-1.lua", "return 1", "@m/data-1.lua")) == 1);
+
+        CHECK(cache.size() == 1);
+        REQUIRE(cached_files(dir).size() == 1);
+        CHECK(fs::file_size(cached_files(dir).front()) > header_size);
+
+        // No temporary files are left behind.
+        CHECK(std::distance(fs::directory_iterator(dir), fs::directory_iterator()) == 1);
+    }
+
+    // Caches "return 1" for "mod", then puts the bytecode of "return 2" into its file.
+    auto cache_probe = [&] {
+        {
+            aengine::BytecodeCache cache(dir);
+            REQUIRE(run(cache.load(view, mod, "data-1.lua", "return 1", "@m/data-1.lua")) == 1);
+        }
+
+        const auto target = cached_files(dir).front();
+
+        {
+            aengine::BytecodeCache cache(dir);
+            REQUIRE(run(cache.load(view, donor, "data-1.lua", "return 2", "@donor/data-1.lua")) == 2);
+        }
+
+        const auto files = cached_files(dir);
+        REQUIRE(files.size() == 2);
+
+        transplant_bytecode(target, files[0] == target ? files[1] : files[0]);
+    };
+
+
+    SUBCASE("a warm load takes the cached chunk") {
+        cache_probe();
+
+        aengine::BytecodeCache cache(dir);
+        CHECK(cache.size() == 2);
+
+        // Source says 1, the chunk on disk says 2.
+        CHECK(run(cache.load(view, mod, "data-1.lua", "return 1", "@m/data-1.lua")) == 2);
+    }
+
+    SUBCASE("a changed source is compiled again") {
+        cache_probe();
+
+        aengine::BytecodeCache cache(dir);
+
+        CHECK(run(cache.load(view, mod, "data-1.lua", "return 3", "@m/data-1.lua")) == 3);
+        CHECK(cache.size() == 2);
+
+        // The file is rewritten for the new source.
+        aengine::BytecodeCache reopened(dir);
+        CHECK(run(reopened.load(view, mod, "data-1.lua", "return 3", "@m/data-1.lua")) == 3);
+        CHECK(cached_files(dir).size() == 2);
+    }
+
+    SUBCASE("a changed mod version is compiled again") {
+        cache_probe();
+
+        aengine::ModIdentity updated = mod;
+        updated.version = { 1, 0, 1 };
+
+        aengine::BytecodeCache cache(dir);
+
+        CHECK(run(cache.load(view, updated, "data-1.lua", "return 1", "@m/data-1.lua")) == 1);
+        CHECK(cache.size() == 2);
+    }
+
+    SUBCASE("broken files are removed when the cache is opened") {
+        {
+            aengine::BytecodeCache cache(dir);
+            CHECK(run(cache.load(view, mod, "data-1.lua", "return 1", "@m/data-1.lua")) == 1);
+            CHECK(run(cache.load(view, mod, "data-2.lua", "return 2", "@m/data-2.lua")) == 2);
+        }
+
+        const auto files = cached_files(dir);
+        REQUIRE(files.size() == 2);
+
+        // Truncated
+        fs::resize_file(files[0], fs::file_size(files[0]) - 1);
+
+        // Foreign magic
+        auto data = read_binary(files[1]);
+        data[0] = 'X';
+        write_binary(files[1], data);
+
+        write_binary(dir / "notes.txt", "not a chunk");
+
+
+        aengine::BytecodeCache cache(dir);
+
+        CHECK(cache.size() == 0);
+        CHECK(fs::is_empty(dir));
+
+        CHECK(run(cache.load(view, mod, "data-1.lua", "return 1", "@m/data-1.lua")) == 1);
+        CHECK(cache.size() == 1);
+    }
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,250 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ers
+#include <erslib/aengine/dependency_graph.hpp>
+#include <erslib/aengine/mod.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+namespace {
+    // Writes "info.json" of a mod into "root" and reads it back.
+    aengine::Mod make_mod(
+        const fs::path& root,
+        std::string_view name,
+        std::initializer_list<std::string_view> dependencies = {},
+        std::string_view version = "1.0.0"
+    ) {
+        const auto dir = root / name;
+        fs::create_directories(dir);
+
+        std::string deps;
+        for (auto dep : dependencies)
+            deps += (deps.empty() ? "\"" : ", \"") + std::string(dep) + "\"";
+
+        std::ofstream(dir / "info.json")
+            << "{ \"name\": \"" << name << "\", \"title\": \"" << name << "\", \"version\": \"" << version
+            << "\", \"author\": \"test\", \"description\": \"test\", \"dependencies\": [" << deps << "] }";
+
+        aengine::Mod mod(dir);
+        mod.init_info();
+        return mod;
+    }
+
+    std::vector<std::string> names(aengine::DependencyGraph& graph, std::string_view initial) {
+        return graph.order_names(initial);
+    }
+
+    using names_t = std::vector<std::string>;
+}
+
+
+TEST_CASE("testing aengine::DependencyGraph") {
+    const auto root = fs::temp_directory_path() / "aengine_dependency_graph_test";
+    fs::remove_all(root);
+
+    const auto base = make_mod(root, "base");
+    const auto a = make_mod(root, "a", { "base" });
+    const auto b = make_mod(root, "b", { "a" });
+    const auto c = make_mod(root, "c");
+    const auto x = make_mod(root, "x");
+    const auto waits_x = make_mod(root, "waits_x", { "?x" });
+
+
+    SUBCASE("a mod nobody refers to is appended to the resolved order") {
+        aengine::DependencyGraph graph;
+        graph.add(base);
+        graph.add(a);
+        CHECK(names(graph, "base") == names_t { "base", "a" });
+
+        // A fresh sort would put "c" right after "base", as it has no dependencies.
+        graph.add(c);
+        CHECK(names(graph, "base") == names_t { "base", "a", "c" });
+
+        graph.add(b);
+        CHECK(names(graph, "base") == names_t { "base", "a", "c", "b" });
+
+        aengine::DependencyGraph fresh;
+        fresh.add(base);
+        fresh.add(a);
+        fresh.add(c);
+        CHECK(names(fresh, "base") == names_t { "base", "c", "a" });
+    }
+
+    SUBCASE("a mod somebody waits for makes the order resolved again") {
+        aengine::DependencyGraph graph;
+        graph.add(base);
+        graph.add(waits_x);
+        CHECK(names(graph, "base") == names_t { "base", "waits_x" });
+
+        graph.add(x);
+        CHECK(names(graph, "base") == names_t { "base", "x", "waits_x" });
+    }
+
+    SUBCASE("removing mods") {
+        aengine::DependencyGraph graph;
+        graph.add(base);
+        graph.add(a);
+        graph.add(b);
+        graph.add(c);
+        CHECK(names(graph, "base") == names_t { "base", "c", "a", "b" });
+
+        CHECK(graph.remove("c"));
+        CHECK_FALSE(graph.remove("c"));
+        CHECK(names(graph, "base") == names_t { "base", "a", "b" });
+
+        // "b" requires "a", so the order can't be kept.
+        CHECK(graph.remove("a"));
+        CHECK_THROWS_AS((void) graph.order("base"), aengine::dependency_error);
+
+        graph.add(a);
+        CHECK(names(graph, "base") == names_t { "base", "a", "b" });
+
+        CHECK(graph.remove("base"));
+        CHECK_THROWS_AS((void) graph.order("base"), aengine::dependency_error);
+    }
+
+    SUBCASE("levels") {
+        aengine::DependencyGraph graph;
+        graph.add(base);
+        graph.add(a);
+        graph.add(b);
+        graph.add(c);
+
+        const auto levels = graph.levels("base");
+        REQUIRE(levels.size() == 3);
+
+        auto level_names = [&graph](const auto& level) {
+            names_t result;
+            for (auto id : level)
+                result.emplace_back(graph.name_of(id));
+            return result;
+        };
+
+        CHECK(level_names(levels[0]) == names_t { "base" });
+        CHECK(level_names(levels[1]) == names_t { "c", "a" });
+        CHECK(level_names(levels[2]) == names_t { "b" });
+    }
+
+    SUBCASE("fingerprint") {
+        aengine::DependencyGraph first, second;
+
+        first.add(base);
+        first.add(a);
+        second.add(a);
+        second.add(base);
+        CHECK(first.fingerprint() == second.fingerprint());
+
+        const auto before = first.fingerprint();
+        first.add(c);
+        CHECK(first.fingerprint() != before);
+        first.remove("c");
+        CHECK(first.fingerprint() == before);
+
+        aengine::DependencyGraph newer;
+        newer.add(base);
+        newer.add(make_mod(root / "newer", "a", { "base" }, "1.1.0"));
+        CHECK(newer.fingerprint() != before);
+    }
+
+    SUBCASE("saved order is adopted only for the same mods") {
+        const auto path = root / "order.json";
+
+        aengine::DependencyGraph graph;
+        graph.add(base);
+        graph.add(a);
+        (void) graph.order("base");
+        graph.add(c);
+        graph.save_order(path);
+
+        aengine::DependencyGraph same;
+        same.add(c);
+        same.add(a);
+        same.add(base);
+        REQUIRE(same.load_order(path, "base"));
+        CHECK(names(same, "base") == names_t { "base", "a", "c" });
+
+        aengine::DependencyGraph other_initial;
+        other_initial.add(base);
+        other_initial.add(a);
+        other_initial.add(c);
+        CHECK_FALSE(other_initial.load_order(path, "c"));
+
+        aengine::DependencyGraph more;
+        more.add(base);
+        more.add(a);
+        more.add(c);
+        more.add(x);
+        CHECK_FALSE(more.load_order(path, "base"));
+
+        // Same size and fingerprint, but "a" takes the place of "c".
+        std::string text;
+        {
+            std::ifstream stream(path);
+            text.assign(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+        }
+
+        const auto pos = text.find("\"c\"");
+        REQUIRE(pos != std::string::npos);
+        std::ofstream(path) << text.replace(pos, 3, "\"a\"");
+
+        aengine::DependencyGraph duplicated;
+        duplicated.add(base);
+        duplicated.add(a);
+        duplicated.add(c);
+        CHECK_FALSE(duplicated.load_order(path, "base"));
+
+        const auto resolved = names(duplicated, "base");
+        CHECK(resolved.size() == 3);
+        CHECK(std::ranges::count(resolved, "c") == 1);
+
+        std::ofstream(path) << "not json";
+        CHECK_FALSE(same.load_order(path, "base"));
+        CHECK_FALSE(same.load_order(root / "missing.json", "base"));
+    }
+
+    SUBCASE("resolve_mods_order goes through the order cache") {
+        const auto path = root / "cache" / "order.json";
+
+        // Mods are move-only, so the container gets its own ones read from the same files.
+        aengine::ModContainer mods;
+        mods.emplace(make_mod(root, "base"));
+        mods.emplace(make_mod(root, "a", { "base" }));
+        mods.emplace(make_mod(root, "c"));
+
+        const auto resolved = aengine::resolve_mods_order(mods, "base", path);
+        CHECK(fs::is_regular_file(path));
+        CHECK(aengine::resolve_mods_order(mods, "base", path) == resolved);
+
+        // Any valid order saved for the same mods is taken as is.
+        aengine::DependencyGraph appended;
+        appended.add(base);
+        appended.add(a);
+        (void) appended.order("base");
+        appended.add(c);
+        appended.save_order(path);
+        CHECK(aengine::resolve_mods_order(mods, "base", path) == names_t { "base", "a", "c" });
+
+        mods.emplace(make_mod(root, "x"));
+        CHECK(aengine::resolve_mods_order(mods, "base", path).size() == 4);
+
+        aengine::DependencyGraph reloaded;
+        for (const auto& mod : mods)
+            reloaded.add(mod);
+        CHECK(reloaded.load_order(path, "base"));
+    }
+
+    fs::remove_all(root);
+}
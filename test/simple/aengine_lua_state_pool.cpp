@@ -0,0 +1,91 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <string_view>
+
+// sol
+#include <sol/sol.hpp>
+
+// ers
+#include <erslib/aengine/lua_state_pool.hpp>
+#include <erslib/aengine/util/sandbox.hpp>
+
+
+namespace {
+    // Runs "code" in a fresh environment falling back to the sandbox, the way mods run.
+    sol::object run_sandboxed(sol::state& lua, std::string_view code) {
+        sol::environment env(lua, sol::create, aengine::util::sandbox_globals(lua));
+        return lua.safe_script(code, env);
+    }
+}
+
+
+TEST_CASE("testing aengine::LuaStatePool") {
+    aengine::LuaStatePool pool(1);
+
+
+    SUBCASE("states are reused") {
+        sol::state* first = nullptr;
+
+        {
+            auto lease = pool.acquire();
+            first = &*lease;
+        }
+
+        CHECK(pool.idle() == 1);
+        CHECK(&*pool.acquire() == first);
+    }
+
+    SUBCASE("unsafe globals are out of reach") {
+        auto lease = pool.acquire();
+
+        CHECK(run_sandboxed(*lease, "return io == nil and loadstring == nil and _G.dofile == nil").as<bool>());
+        CHECK(run_sandboxed(*lease, "return getfenv(0) == _G and getfenv(print) == _G").as<bool>());
+        CHECK(run_sandboxed(*lease, "return getfenv(0).loadstring == nil").as<bool>());
+        CHECK(run_sandboxed(*lease, "local function f() return getfenv(1) end return getfenv(f) == getfenv()").as<bool>());
+    }
+
+    SUBCASE("mutations of one lease are invisible in the next one") {
+        sol::state* first = nullptr;
+
+        {
+            auto lease = pool.acquire();
+            first = &*lease;
+
+            run_sandboxed(*lease, R"(
+                leaked = 1
+                _G.leaked_global = 1
+                string.leaked = 1
+                table.insert = nil
+
+                setmetatable(_G, { __index = function() return "leaked" end, __metatable = "locked" })
+                setmetatable(string, { __index = function() return "leaked" end })
+
+                local string_meta = getmetatable("")
+                string_meta.leaked = 1
+                string_meta.__index = { upper = function() return "leaked" end }
+
+                setfenv(0, {})
+            )");
+
+            (*lease)["host_leaked"] = 1;
+        }
+
+        auto lease = pool.acquire();
+        auto& lua = *lease;
+
+        // Otherwise the state failed to be restored and was closed.
+        REQUIRE(&lua == first);
+
+        CHECK(run_sandboxed(lua, "return leaked == nil and leaked_global == nil and missing == nil").as<bool>());
+        CHECK(run_sandboxed(lua, "return string.leaked == nil and type(table.insert) == 'function'").as<bool>());
+        CHECK(run_sandboxed(lua, "return getmetatable(_G) == nil and getmetatable(string) == nil").as<bool>());
+        CHECK(run_sandboxed(lua, "return getmetatable('').leaked == nil and ('a'):upper() == 'A'").as<bool>());
+
+        // The main thread runs in the real globals again, as they were before the lease.
+        CHECK(lua.globals().raw_get<sol::object>("print").is<sol::function>());
+        CHECK(lua.globals().raw_get<sol::object>("host_leaked").get_type() == sol::type::lua_nil);
+        CHECK(lua.safe_script("return type(print) == 'function'").get<bool>());
+    }
+}
@@ -0,0 +1,165 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+// ers
+#include <erslib/aengine/mod_archive.hpp>
+#include <erslib/core/exception.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+namespace {
+    constexpr size_t entry_size = 40;
+    constexpr size_t index_offset_position = 16;
+
+
+    void write(const fs::path& path, std::string_view text) {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path, std::ios::binary) << text;
+    }
+
+    std::uint64_t read_index_offset(const fs::path& archive) {
+        std::uint64_t offset = 0;
+
+        std::ifstream stream(archive, std::ios::binary);
+        stream.seekg(index_offset_position);
+        stream.read(reinterpret_cast<char*>(&offset), sizeof(offset));
+
+        return offset;
+    }
+
+    // Swaps two index entries in place, paths stay where they are.
+    void swap_entries(const fs::path& archive, size_t a, size_t b) {
+        const auto index = read_index_offset(archive);
+
+        std::array<char, entry_size> first {}, second {};
+
+        std::fstream stream(archive, std::ios::binary | std::ios::in | std::ios::out);
+
+        stream.seekg(static_cast<std::streamoff>(index + a * entry_size));
+        stream.read(first.data(), entry_size);
+        stream.seekg(static_cast<std::streamoff>(index + b * entry_size));
+        stream.read(second.data(), entry_size);
+
+        stream.seekp(static_cast<std::streamoff>(index + a * entry_size));
+        stream.write(second.data(), entry_size);
+        stream.seekp(static_cast<std::streamoff>(index + b * entry_size));
+        stream.write(first.data(), entry_size);
+    }
+}
+
+
+TEST_CASE("testing aengine::ModArchive") {
+    const auto root = fs::temp_directory_path() / "aengine_mod_archive_test";
+    fs::remove_all(root);
+
+    const auto dir = root / "m";
+    const auto archive = root / ("m" + std::string(aengine::ModArchive::extension));
+
+    write(dir / "info.json", "{ \"name\": \"m\" }");
+    write(dir / "data-1.lua", "return 1");
+    write(dir / "lib" / "deep" / "util.lua", "return { value = 2 }");
+    write(dir / "empty.lua", "");
+
+    aengine::pack_mod_archive(dir, archive);
+
+
+    SUBCASE("packed files are read back") {
+        const aengine::ModArchive mod(archive);
+
+        CHECK(mod.path() == archive);
+        REQUIRE(mod.size() == 4);
+        CHECK(mod.verify());
+
+        CHECK(mod.at(0).path == "data-1.lua");
+        CHECK(mod.at(1).path == "empty.lua");
+        CHECK(mod.at(2).path == "info.json");
+        CHECK(mod.at(3).path == "lib/deep/util.lua");
+
+        CHECK(mod.at(0).data == "return 1");
+        CHECK(mod.at(3).data == "return { value = 2 }");
+
+        for (size_t i = 0; i < mod.size(); i++) {
+            const auto file = mod.at(i);
+            const auto found = mod.find(file.path);
+
+            REQUIRE(found.has_value());
+            CHECK(found->data == file.data);
+            CHECK(found->hash == file.hash);
+        }
+
+        CHECK(mod.find("empty.lua")->data.empty());
+        CHECK_FALSE(mod.find("missing.lua").has_value());
+        CHECK_FALSE(mod.find("lib/deep").has_value());
+    }
+
+    SUBCASE("indexes past the end are out of range") {
+        const aengine::ModArchive mod(archive);
+
+        CHECK_THROWS_AS(static_cast<void>(mod.at(mod.size())), ers::out_of_range_error);
+        CHECK_THROWS_AS(static_cast<void>(mod.at(static_cast<size_t>(-1))), std::out_of_range);
+
+        try {
+            static_cast<void>(mod.at(4));
+            FAIL("at(4) should throw");
+        } catch (const ers::out_of_range_error& e) {
+            CHECK(std::string_view(e.what()).find(archive.string()) != std::string_view::npos);
+        }
+    }
+
+    SUBCASE("changed contents fail verification") {
+        {
+            std::fstream stream(archive, std::ios::binary | std::ios::in | std::ios::out);
+            stream.seekp(static_cast<std::streamoff>(read_index_offset(archive) - 1));
+            stream.put('!');
+        }
+
+        const aengine::ModArchive mod(archive);
+        CHECK_FALSE(mod.verify());
+    }
+
+    SUBCASE("truncated archives are rejected") {
+        const auto size = fs::file_size(archive);
+
+        fs::resize_file(archive, size - 1);
+        CHECK_THROWS(aengine::ModArchive(archive));
+
+        fs::resize_file(archive, read_index_offset(archive) + entry_size);
+        CHECK_THROWS(aengine::ModArchive(archive));
+
+        fs::resize_file(archive, 8);
+        CHECK_THROWS(aengine::ModArchive(archive));
+    }
+
+    SUBCASE("unsorted index is rejected") {
+        swap_entries(archive, 1, 2);
+        CHECK_THROWS(aengine::ModArchive(archive));
+    }
+
+    SUBCASE("repacking replaces the archive") {
+        write(dir / "data-2.lua", "return 2");
+        fs::remove(dir / "empty.lua");
+
+        aengine::pack_mod_archive(dir, archive);
+
+        const aengine::ModArchive mod(archive);
+
+        CHECK(mod.size() == 4);
+        CHECK(mod.verify());
+        CHECK(mod.find("data-2.lua")->data == "return 2");
+        CHECK_FALSE(mod.find("empty.lua").has_value());
+        CHECK_FALSE(fs::exists(fs::path(archive) += ".tmp"));
+    }
+
+    fs::remove_all(root);
+}
@@ -0,0 +1,132 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ers
+#include <erslib/aengine/mod_loader.hpp>
+#include <erslib/aengine/util/stage.hpp>
+#include <erslib/core/thread_safe.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+namespace {
+    void write_mod(const fs::path& root, std::string_view name, std::initializer_list<std::string_view> dependencies = {}) {
+        const auto dir = root / name;
+        fs::create_directories(dir);
+
+        std::string deps;
+        for (auto dep : dependencies)
+            deps += (deps.empty() ? "\"" : ", \"") + std::string(dep) + "\"";
+
+        std::ofstream(dir / "info.json")
+            << "{ \"name\": \"" << name << "\", \"title\": \"" << name << "\", \"version\": \"1.0.0\""
+            << ", \"author\": \"test\", \"description\": \"test\", \"dependencies\": [" << deps << "] }";
+
+        std::ofstream(dir / "data-1.lua") << "return nil";
+        std::ofstream(dir / "util.lua") << "return {}";
+    }
+
+    void write_broken_mod(const fs::path& root, std::string_view name) {
+        const auto dir = root / name;
+        fs::create_directories(dir);
+
+        std::ofstream(dir / "info.json") << "{ \"name\": ";
+    }
+
+    bool is_duplicate_error(const std::exception& e) {
+        return std::string_view(e.what()).find("installed twice") != std::string_view::npos;
+    }
+
+    using names_t = std::vector<std::string>;
+}
+
+
+TEST_CASE("testing aengine::discover_mods") {
+    const auto root = fs::temp_directory_path() / "aengine_mod_loader_test";
+    fs::remove_all(root);
+
+    const std::vector<fs::path> roots = { root / "first", root / "second" };
+
+    write_mod(roots[0], "base");
+    write_mod(roots[1], "extra", { "base" });
+
+    ers::thread_safe::WorkerPool pool(2);
+
+
+    SUBCASE("mods of every root are read") {
+        std::atomic<size_t> calls = 0;
+
+        const auto mods = aengine::discover_mods(roots, [&calls](std::string_view name) {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            return aengine::util::is_stage_naming_scheme(name);
+        }, pool);
+
+        REQUIRE(mods.size() == 2);
+        CHECK(calls.load() == 4);
+
+        const auto extra = mods.find("extra");
+        REQUIRE(extra != mods.end());
+        CHECK(extra->dir() == roots[1] / "extra");
+        CHECK(extra->content().stages.contains("data-1"));
+        CHECK(extra->content().packages.contains("util"));
+    }
+
+    SUBCASE("load_mods orders discovered mods") {
+        const auto loaded = aengine::load_mods(roots, "base", &aengine::util::is_stage_naming_scheme, pool);
+
+        CHECK(loaded.mods.size() == 2);
+        CHECK(loaded.order == names_t { "base", "extra" });
+    }
+
+    SUBCASE("missing roots are reported") {
+        const std::vector<fs::path> missing = { root / "missing" };
+        CHECK_THROWS(aengine::discover_mods(missing, &aengine::util::is_stage_naming_scheme, pool));
+    }
+
+    SUBCASE("mods installed twice are reported") {
+        write_mod(roots[1], "base");
+
+        try {
+            (void) aengine::discover_mods(roots, &aengine::util::is_stage_naming_scheme, pool);
+            FAIL("duplicate mod should be reported");
+        } catch (const std::exception& e) {
+            CHECK(is_duplicate_error(e));
+        }
+    }
+
+    SUBCASE("a broken mod found first is reported over a later duplicate") {
+        write_broken_mod(roots[0], "broken");
+        write_mod(roots[1], "base");
+
+        try {
+            (void) aengine::discover_mods(roots, &aengine::util::is_stage_naming_scheme, pool);
+            FAIL("broken mod should be reported");
+        } catch (const std::exception& e) {
+            CHECK_FALSE(is_duplicate_error(e));
+        }
+    }
+
+    SUBCASE("a duplicate found first is reported over a later broken mod") {
+        write_mod(roots[1], "base");
+        write_broken_mod(roots[1], "zbroken");
+
+        try {
+            (void) aengine::discover_mods(roots, &aengine::util::is_stage_naming_scheme, pool);
+            FAIL("duplicate mod should be reported");
+        } catch (const std::exception& e) {
+            CHECK(is_duplicate_error(e));
+        }
+    }
+
+    fs::remove_all(root);
+}
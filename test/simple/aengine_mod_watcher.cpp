@@ -0,0 +1,252 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// sol
+#include <sol/state.hpp>
+
+// ers
+#include <erslib/aengine/mod.hpp>
+#include <erslib/aengine/mod_watcher.hpp>
+#include <erslib/aengine/util/stage.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+namespace {
+    void write(const fs::path& path, std::string_view text) {
+        fs::create_directories(path.parent_path());
+        std::ofstream(path) << text;
+    }
+
+    // "data-1" requires "lib.util", which requires "lib.base", nothing requires "data-2" and "final-1".
+    aengine::Mod make_mod(const fs::path& dir) {
+        write(dir / "info.json",
+            "{ \"name\": \"" + dir.filename().string() + "\", \"title\": \"test\", \"version\": \"1.0.0\""
+            ", \"author\": \"test\", \"description\": \"test\", \"dependencies\": [] }");
+
+        write(dir / "data-1.lua", "value = require('lib.util').value");
+        write(dir / "data-2.lua", "return nil");
+        write(dir / "final-1.lua", "return nil");
+        write(dir / "lib" / "util.lua", "return { value = require('lib.base').value }");
+        write(dir / "lib" / "base.lua", "return { value = 1 }");
+
+        aengine::Mod mod(dir);
+        mod.init_info();
+        mod.init_content(&aengine::util::is_stage_naming_scheme);
+        return mod;
+    }
+
+    using names_t = std::vector<std::string>;
+}
+
+
+TEST_CASE("testing aengine::Mod::reload_files") {
+    const auto root = fs::temp_directory_path() / "aengine_reload_files_test";
+    fs::remove_all(root);
+
+    const auto dir = root / "m";
+    const auto mod = make_mod(dir);
+
+
+    SUBCASE("changed and added sources are read again") {
+        write(dir / "data-2.lua", "return 2");
+        write(dir / "data-3.lua", "return 3");
+        write(dir / "lib" / "extra.lua", "return {}");
+
+        const std::vector<fs::path> files = { dir / "data-2.lua", dir / "data-3.lua", dir / "lib" / "extra.lua" };
+
+        CHECK(mod.reload_files(files, &aengine::util::is_stage_naming_scheme) == names_t { "data-2", "data-3" });
+        CHECK(mod.content().stages.at("data-2") == "return 2");
+        CHECK(mod.content().stage_infos.at("data-3").index == 3);
+        CHECK(mod.content().packages.contains("lib.extra"));
+    }
+
+    SUBCASE("removed sources are erased") {
+        fs::remove(dir / "final-1.lua");
+        fs::remove(dir / "lib" / "base.lua");
+
+        const std::vector<fs::path> files = { dir / "final-1.lua", dir / "lib" / "base.lua" };
+
+        CHECK(mod.reload_files(files, &aengine::util::is_stage_naming_scheme).empty());
+        CHECK_FALSE(mod.content().stages.contains("final-1"));
+        CHECK_FALSE(mod.content().stage_infos.contains("final-1"));
+        CHECK_FALSE(mod.content().packages.contains("lib.base"));
+        CHECK(mod.content().packages.contains("lib.util"));
+    }
+
+    SUBCASE("other files are skipped") {
+        write(dir / "readme.txt", "text");
+
+        const std::vector<fs::path> files = { dir / "readme.txt" };
+
+        CHECK(mod.reload_files(files, &aengine::util::is_stage_naming_scheme).empty());
+        CHECK(mod.content().stages.size() == 3);
+        CHECK(mod.content().packages.size() == 2);
+    }
+
+    SUBCASE("a changed package invalidates stages requiring it through other packages") {
+        // Requires are recorded as stages run, so this one needs a Lua state.
+        sol::state lua;
+        sol::state_view view(lua);
+
+        mod.init_runtime(view);
+        mod.load_runtime("data-1");
+        mod.load_runtime("data-2");
+
+        CHECK(mod.runtime().modules_cache.contains("lib.base"));
+        CHECK(mod.runtime().modules_cache.contains("lib.util"));
+
+        write(dir / "lib" / "base.lua", "return { value = 2 }");
+
+        const std::vector<fs::path> files = { dir / "lib" / "base.lua" };
+
+        CHECK(mod.reload_files(files, &aengine::util::is_stage_naming_scheme) == names_t { "data-1" });
+        CHECK_FALSE(mod.runtime().modules_cache.contains("lib.base"));
+        CHECK_FALSE(mod.runtime().modules_cache.contains("lib.util"));
+
+        mod.load_runtime("data-1");
+        CHECK(mod.runtime().env.get<int>("value") == 2);
+
+        mod.drop_runtime();
+    }
+
+    fs::remove_all(root);
+}
+
+
+TEST_CASE("testing aengine::apply_mod_changes") {
+    const auto root = fs::temp_directory_path() / "aengine_apply_mod_changes_test";
+    fs::remove_all(root);
+
+    aengine::ModContainer mods;
+    mods.emplace(make_mod(root / "a"));
+    mods.emplace(make_mod(root / "b"));
+    mods.emplace(make_mod(root / "unordered"));
+
+    const std::vector<std::string> mods_order = { "a", "b" };
+    const std::vector<std::string> phases_order = { "data", "final" };
+
+
+    SUBCASE("stages are ordered by phase, then by mod") {
+        const std::vector<aengine::mod_change_t> changes = {
+            { .mod = "b", .files = { root / "b" / "data-2.lua" } },
+            { .mod = "a", .files = { root / "a" / "final-1.lua", root / "a" / "data-2.lua", root / "a" / "data-1.lua" } },
+            { .mod = "unordered", .files = { root / "unordered" / "data-1.lua" } }
+        };
+
+        const auto plan = aengine::apply_mod_changes(mods, changes, &aengine::util::is_stage_naming_scheme,
+            mods_order, phases_order);
+
+        CHECK(plan.reinit.empty());
+        REQUIRE(plan.stages.size() == 4);
+
+        auto check_stage = [](const aengine::stage_order_info_t& stage, std::string_view mod, std::string_view phase, size_t index) {
+            CHECK(stage.mod == mod);
+            CHECK(stage.phase == phase);
+            CHECK(stage.index == index);
+        };
+
+        check_stage(plan.stages[0], "a", "data", 1);
+        check_stage(plan.stages[1], "a", "data", 2);
+        check_stage(plan.stages[2], "b", "data", 2);
+        check_stage(plan.stages[3], "a", "final", 1);
+    }
+
+    SUBCASE("reinit and unknown mods are only reported") {
+        write(root / "a" / "data-1.lua", "return 1");
+
+        const std::vector<aengine::mod_change_t> changes = {
+            { .mod = "a", .files = { root / "a" / "data-1.lua" }, .reinit = true },
+            { .mod = "missing", .files = { root / "missing" / "data-1.lua" } }
+        };
+
+        const auto plan = aengine::apply_mod_changes(mods, changes, &aengine::util::is_stage_naming_scheme,
+            mods_order, phases_order);
+
+        CHECK(plan.reinit == names_t { "a", "missing" });
+        CHECK(plan.stages.empty());
+        CHECK(mods.find("a")->content().stages.at("data-1") != "return 1");
+    }
+
+    SUBCASE("removed stages aren't run again") {
+        fs::remove(root / "a" / "data-2.lua");
+
+        const std::vector<aengine::mod_change_t> changes = {
+            { .mod = "a", .files = { root / "a" / "data-2.lua" } }
+        };
+
+        const auto plan = aengine::apply_mod_changes(mods, changes, &aengine::util::is_stage_naming_scheme,
+            mods_order, phases_order);
+
+        CHECK(plan.stages.empty());
+        CHECK_FALSE(mods.find("a")->content().stages.contains("data-2"));
+    }
+
+    fs::remove_all(root);
+}
+
+
+#ifdef __linux__
+
+TEST_CASE("testing aengine::ModWatcher") {
+    const auto root = fs::temp_directory_path() / "aengine_mod_watcher_test";
+    fs::remove_all(root);
+
+    aengine::ModContainer mods;
+    mods.emplace(make_mod(root / "a"));
+    mods.emplace(make_mod(root / "b"));
+
+    aengine::ModWatcher watcher(mods);
+    CHECK(watcher.poll().empty());
+
+
+    // All of it is queued before "poll", so one call sees everything.
+    write(root / "a" / "data-2.lua", "return 2");
+    write(root / "a" / "lib" / "new" / "extra.lua", "return {}");
+    write(root / "a" / "readme.txt", "text");
+    write(root / "b" / "info.json",
+        "{ \"name\": \"b\", \"title\": \"test\", \"version\": \"1.0.1\""
+        ", \"author\": \"test\", \"description\": \"test\", \"dependencies\": [] }");
+
+    const auto changes = watcher.poll(std::chrono::milliseconds(1000));
+    REQUIRE(changes.size() == 2);
+
+    const auto a = std::ranges::find(changes, "a", &aengine::mod_change_t::mod);
+    const auto b = std::ranges::find(changes, "b", &aengine::mod_change_t::mod);
+    REQUIRE(a != changes.end());
+    REQUIRE(b != changes.end());
+
+    // A new file is seen by several events, it is still reported once.
+    CHECK_FALSE(a->reinit);
+    REQUIRE(a->files.size() == 2);
+    CHECK(std::ranges::count(a->files, root / "a" / "data-2.lua") == 1);
+    CHECK(std::ranges::count(a->files, root / "a" / "lib" / "new" / "extra.lua") == 1);
+
+    CHECK(b->reinit);
+    CHECK(b->files.empty());
+
+
+    // The new directory is watched as well.
+    write(root / "a" / "lib" / "new" / "extra.lua", "return { value = 1 }");
+
+    const auto later = watcher.poll(std::chrono::milliseconds(1000));
+    REQUIRE(later.size() == 1);
+    CHECK(later[0].mod == "a");
+    CHECK(later[0].files == std::vector<fs::path> { root / "a" / "lib" / "new" / "extra.lua" });
+
+    CHECK(watcher.poll().empty());
+
+    fs::remove_all(root);
+}
+
+#endif
@@ -0,0 +1,128 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+// ers
+#include <erslib/aengine/resource.hpp>
+
+
+namespace {
+    struct counters_t {
+        std::atomic<size_t> loads = 0;
+        std::atomic<size_t> unloads = 0;
+    };
+
+    aengine::TResource<int> make_counted(counters_t& counters) {
+        return aengine::TResource<int>(
+            [&counters](auto& cb) -> ers::Status {
+                counters.loads++;
+                cb.value.emplace(42);
+                return ers::ok;
+            },
+            [&counters](auto& cb) {
+                counters.unloads++;
+                cb.value.reset();
+            }
+        );
+    }
+}
+
+
+TEST_CASE("testing aengine::TResource") {
+    counters_t counters;
+
+
+    SUBCASE("loads on the first view and unloads after the last handle") {
+        auto resource = make_counted(counters);
+        CHECK(resource.state() == aengine::ResourceState::Empty);
+
+        {
+            auto first = resource.view();
+            REQUIRE(first);
+            CHECK(**first == 42);
+
+            auto second = resource.view();
+            REQUIRE(second);
+            CHECK(first->use_count() == 2);
+            CHECK(counters.loads == 1);
+            CHECK(resource.state() == aengine::ResourceState::Ready);
+        }
+
+        CHECK(counters.unloads == 1);
+        CHECK(resource.state() == aengine::ResourceState::Empty);
+    }
+
+    SUBCASE("failed load can be retried") {
+        size_t attempts = 0;
+
+        aengine::TResource<int> resource([&attempts](auto& cb) -> ers::Status {
+            if (++attempts == 1)
+                return ers::make_error("Not yet");
+
+            cb.value.emplace(7);
+            return ers::ok;
+        });
+
+        CHECK(resource.view().has_error());
+        CHECK(resource.state() == aengine::ResourceState::Empty);
+        CHECK(resource.control_block().refs == 0);
+
+        auto handle = resource.view();
+        REQUIRE(handle);
+        CHECK(**handle == 7);
+        CHECK(handle->use_count() == 1);
+        CHECK(attempts == 2);
+    }
+
+    SUBCASE("throwing loader leaves the resource empty") {
+        bool fail = true;
+
+        aengine::TResource<int> resource([&fail](auto& cb) -> ers::Status {
+            if (fail)
+                throw std::runtime_error("broken loader");
+
+            cb.value.emplace(1);
+            return ers::ok;
+        });
+
+        CHECK_THROWS_AS((void) resource.view(), std::runtime_error);
+        CHECK(resource.state() == aengine::ResourceState::Empty);
+        CHECK(resource.control_block().refs == 0);
+
+        fail = false;
+        auto handle = resource.view();
+        REQUIRE(handle);
+        CHECK(**handle == 1);
+    }
+
+    SUBCASE("concurrent view and release") {
+        auto resource = make_counted(counters);
+        std::atomic<size_t> wrong_values = 0;
+
+        {
+            std::vector<std::jthread> workers;
+
+            for (size_t t = 0; t < 4; t++) {
+                workers.emplace_back([&resource, &wrong_values] {
+                    for (size_t i = 0; i < 2000; i++) {
+                        auto handle = resource.view();
+
+                        if (!handle || **handle != 42)
+                            wrong_values++;
+                    }
+                });
+            }
+        }
+
+        CHECK(wrong_values == 0);
+        CHECK(counters.loads >= 1);
+        CHECK(counters.loads == counters.unloads);
+        CHECK(resource.control_block().refs == 0);
+        CHECK(resource.state() == aengine::ResourceState::Empty);
+    }
+}
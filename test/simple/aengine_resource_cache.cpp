@@ -0,0 +1,148 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <memory>
+#include <string>
+#include <vector>
+
+// ers
+#include <erslib/core/fwd.hpp>
+#include <erslib/aengine/resource.hpp>
+#include <erslib/aengine/resource_cache.hpp>
+
+
+namespace {
+    struct blob_t {
+        size_t bytes;
+    };
+}
+
+template<>
+struct aengine::resource_size<blob_t> {
+    size_t operator()(const blob_t& blob) const noexcept {
+        return blob.bytes;
+    }
+};
+
+
+namespace {
+    // Resources of 10 bytes each, unloads are recorded in order.
+    class Resources {
+    public:
+        aengine::Handle<blob_t> view(const std::string& key) {
+            auto it = m_data.find(key);
+
+            if (it == m_data.end()) {
+                it = m_data.emplace(key, std::make_unique<aengine::TResource<blob_t>>(
+                    [](auto& cb) -> ers::Status {
+                        cb.value.emplace(blob_t { 10 });
+                        return ers::ok;
+                    },
+                    [this, key](auto& cb) {
+                        unloaded.push_back(key);
+                        cb.value.reset();
+                    }
+                )).first;
+            }
+
+            return *it->second->view();
+        }
+
+        // Caches the resource without keeping any handle outside of the cache.
+        void touch(aengine::ResourceCache& cache, const std::string& key) {
+            cache.retain(key, view(key));
+        }
+
+
+        std::vector<std::string> unloaded;
+
+
+    private:
+        ers::StringMap<std::unique_ptr<aengine::TResource<blob_t>>> m_data;
+    };
+}
+
+
+TEST_CASE("testing aengine::ResourceCache") {
+    Resources resources;
+
+
+    SUBCASE("evicts the oldest entry that wasn't hit") {
+        aengine::ResourceCache cache(30);
+
+        resources.touch(cache, "a");
+        resources.touch(cache, "b");
+        resources.touch(cache, "c");
+        CHECK(cache.usage() == 30);
+        CHECK(resources.unloaded.empty());
+
+        resources.touch(cache, "d");
+        CHECK(resources.unloaded == std::vector<std::string> { "a" });
+        CHECK(cache.usage() == 30);
+        CHECK(cache.size() == 3);
+
+        // The last pass cleared every bit, so only "b" and "c" are hit since then.
+        resources.touch(cache, "b");
+        resources.touch(cache, "c");
+        resources.touch(cache, "e");
+        CHECK(resources.unloaded == std::vector<std::string> { "a", "d" });
+        CHECK(cache.size() == 3);
+    }
+
+    SUBCASE("resources in use are never evicted") {
+        aengine::ResourceCache cache(10);
+
+        auto a = resources.view("a");
+        cache.retain("a", a);
+
+        // The caller's handle is still alive while "b" is retained, so it's only evicted by the next trim.
+        resources.touch(cache, "b");
+        CHECK(resources.unloaded.empty());
+        CHECK(cache.trim() == 10);
+        CHECK(resources.unloaded == std::vector<std::string> { "b" });
+
+        auto c = resources.view("c");
+        cache.retain("c", c);
+        CHECK(cache.trim() == 0);
+        CHECK(resources.unloaded.size() == 1);
+        CHECK(cache.usage() == 20);
+        CHECK(cache.size() == 2);
+    }
+
+    SUBCASE("trim") {
+        aengine::ResourceCache cache(100);
+
+        resources.touch(cache, "a");
+        resources.touch(cache, "b");
+        resources.touch(cache, "c");
+
+        CHECK(cache.trim() == 0);
+        CHECK(cache.trim(15) == 20);
+        CHECK(cache.usage() == 10);
+        CHECK(cache.size() == 1);
+        CHECK(resources.unloaded.size() == 2);
+
+        CHECK(cache.trim(0) == 10);
+        CHECK(cache.size() == 0);
+        CHECK(resources.unloaded.size() == 3);
+    }
+
+    SUBCASE("budget 0") {
+        aengine::ResourceCache cache(0);
+
+        resources.touch(cache, "a");
+        CHECK(cache.size() == 0);
+        CHECK(cache.usage() == 0);
+        CHECK(resources.unloaded == std::vector<std::string> { "a" });
+
+        cache.set_budget(100);
+        resources.touch(cache, "a");
+        resources.touch(cache, "b");
+        CHECK(cache.size() == 2);
+
+        cache.set_budget(0);
+        CHECK(cache.size() == 0);
+        CHECK(resources.unloaded.size() == 3);
+    }
+}
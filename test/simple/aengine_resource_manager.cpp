@@ -0,0 +1,125 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <atomic>
+#include <future>
+#include <string>
+#include <string_view>
+
+// ers
+#include <erslib/aengine/manager.hpp>
+
+
+namespace {
+    struct counters_t {
+        std::atomic<size_t> loads = 0;
+        std::atomic<size_t> unloads = 0;
+    };
+
+    // Loads 42 for "answer", "gate" is waited on by the load of "slow".
+    // Outlives the manager, its unloads may run while the manager is destroyed.
+    struct resources_t {
+        void add_to(aengine::ResourceManager& manager) {
+            manager.set<int>(std::string("answer"),
+                [this](auto& cb) -> ers::Status {
+                    counters.loads++;
+                    cb.value.emplace(42);
+                    return ers::ok;
+                },
+                [this](auto& cb) {
+                    counters.unloads++;
+                    cb.value.reset();
+                }
+            );
+
+            manager.set<int>(std::string("slow"), [this](auto& cb) -> ers::Status {
+                started = true;
+                started.notify_all();
+
+                gate_opened.wait();
+                cb.value.emplace(1);
+                return ers::ok;
+            });
+        }
+
+
+        void wait_started() const {
+            started.wait(false);
+        }
+
+
+        counters_t counters;
+
+        std::atomic<bool> started = false;
+        std::promise<void> gate;
+        std::shared_future<void> gate_opened = gate.get_future().share();
+    };
+}
+
+
+TEST_CASE("testing aengine::ResourceManager") {
+    resources_t resources;
+
+    // One loader keeps queued loads in order, no budget keeps the cache out of the way.
+    aengine::ResourceManager manager(1, 0);
+    resources.add_to(manager);
+
+
+    SUBCASE("an async load gives the same resource as get") {
+        auto sync = manager.get<int>(std::string("answer"));
+        REQUIRE(sync);
+
+        auto pending = manager.get_async<int>(std::string("answer"));
+        REQUIRE(pending.valid());
+
+        auto async = pending.get();
+        REQUIRE(async);
+
+        CHECK(async->get() == sync->get());
+        CHECK(**async == 42);
+        CHECK(sync->use_count() == 2);
+        CHECK(resources.counters.loads == 1);
+
+        auto missing = manager.get_async<int>(std::string("missing"));
+        CHECK(missing.get().has_error());
+    }
+
+    SUBCASE("a load cancelled before it has started is skipped") {
+        auto slow = manager.get_async<int>(std::string("slow"));
+        resources.wait_started();
+
+        auto pending = manager.get_async<int>(std::string("answer"));
+        pending.cancel();
+
+        resources.gate.set_value();
+
+        CHECK(slow.get());
+
+        auto result = pending.get();
+        REQUIRE(result.has_error());
+        CHECK(std::string_view(result.error().message()).find("is cancelled") != std::string_view::npos);
+        CHECK(resources.counters.loads == 0);
+    }
+
+    SUBCASE("a prefetched resource stays loaded until it's released") {
+        manager.prefetch<int>(std::string("answer"));
+        manager.wait_loads();
+
+        CHECK(resources.counters.loads == 1);
+        CHECK(resources.counters.unloads == 0);
+
+        {
+            auto handle = manager.get<int>(std::string("answer"));
+            REQUIRE(handle);
+            CHECK(handle->use_count() == 2);
+        }
+
+        CHECK(resources.counters.unloads == 0);
+
+        manager.release_prefetched("answer");
+
+        CHECK(resources.counters.loads == 1);
+        CHECK(resources.counters.unloads == 1);
+    }
+}
@@ -0,0 +1,168 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+// ers
+#include <erslib/aengine/setting.hpp>
+
+
+using aengine::impl::allowed_values_t;
+using aengine::impl::value_bounds_t;
+
+
+TEST_CASE("testing aengine::BoolSetting") {
+    SUBCASE("any value is accepted") {
+        aengine::BoolSetting setting(true);
+
+        CHECK(setting.value());
+        CHECK_FALSE(setting.is_forced());
+        CHECK(setting.accepts(false));
+
+        CHECK(setting.set(false));
+        CHECK_FALSE(setting.value());
+
+        setting.reset();
+        CHECK(setting.value());
+    }
+
+    SUBCASE("forced value is kept") {
+        aengine::BoolSetting setting(false, true);
+
+        CHECK(setting.is_forced());
+        CHECK(setting.value());
+        CHECK_FALSE(setting.default_value());
+
+        CHECK_FALSE(setting.accepts(false));
+        CHECK_FALSE(setting.set(false));
+        CHECK(setting.value());
+
+        CHECK(setting.set(true));
+
+        setting.reset();
+        CHECK(setting.value());
+    }
+}
+
+
+TEST_CASE("testing aengine::IntSetting") {
+    SUBCASE("bounds are inclusive") {
+        aengine::IntSetting setting(60, value_bounds_t<i64> { 30, 240 });
+
+        CHECK(setting.accepts(30));
+        CHECK(setting.accepts(240));
+        CHECK_FALSE(setting.accepts(29));
+        CHECK_FALSE(setting.accepts(241));
+
+        CHECK(setting.set(144));
+        CHECK(setting.value() == 144);
+
+        CHECK_FALSE(setting.set(1000));
+        CHECK(setting.value() == 144);
+
+        setting.reset();
+        CHECK(setting.value() == 60);
+    }
+
+    SUBCASE("allowed values") {
+        aengine::IntSetting setting(2, allowed_values_t<i64> { 1, 2, 4 });
+
+        CHECK(setting.set(4));
+        CHECK_FALSE(setting.set(3));
+        CHECK(setting.value() == 4);
+    }
+
+    SUBCASE("default value should pass the checks") {
+        CHECK_THROWS_AS(aengine::IntSetting(10, value_bounds_t<i64> { 30, 240 }), std::invalid_argument);
+        CHECK_THROWS_AS(aengine::IntSetting(3, allowed_values_t<i64> { 1, 2, 4 }), std::invalid_argument);
+    }
+}
+
+
+TEST_CASE("testing aengine::DoubleSetting") {
+    SUBCASE("bounds are inclusive") {
+        aengine::DoubleSetting setting(1.0, value_bounds_t<f64> { 0.5, 2.0 });
+
+        CHECK(setting.accepts(0.5));
+        CHECK(setting.accepts(2.0));
+        CHECK_FALSE(setting.accepts(0.25));
+
+        CHECK(setting.set(1.5));
+        CHECK(setting.value() == 1.5);
+
+        CHECK_FALSE(setting.set(4.0));
+        CHECK(setting.value() == 1.5);
+
+        setting.reset();
+        CHECK(setting.value() == 1.0);
+    }
+
+    SUBCASE("NaN is never accepted") {
+        aengine::DoubleSetting setting(1.0);
+
+        CHECK(setting.accepts(std::numeric_limits<f64>::infinity()));
+        CHECK_FALSE(setting.accepts(std::nan("")));
+        CHECK_FALSE(setting.set(std::nan("")));
+        CHECK(setting.value() == 1.0);
+
+        CHECK_THROWS_AS(aengine::DoubleSetting(std::nan("")), std::invalid_argument);
+    }
+}
+
+
+TEST_CASE("testing aengine::StringSetting") {
+    SUBCASE("any value is accepted by default") {
+        aengine::StringSetting setting("en");
+
+        CHECK(setting.set(""));
+        CHECK(setting.value().empty());
+
+        CHECK(setting.set(" x "));
+        CHECK(setting.value() == " x ");
+
+        setting.reset();
+        CHECK(setting.value() == "en");
+    }
+
+    SUBCASE("blank values") {
+        aengine::StringSetting setting("en", false);
+
+        CHECK_FALSE(setting.accepts(""));
+        CHECK_FALSE(setting.set(" \t"));
+        CHECK(setting.value() == "en");
+
+        CHECK_THROWS_AS(aengine::StringSetting(" ", false), std::invalid_argument);
+    }
+
+    SUBCASE("values are trimmed before they're checked") {
+        aengine::StringSetting setting(" en ", false, true, allowed_values_t<std::string> { "en", "ru" });
+
+        CHECK(setting.default_value() == "en");
+        CHECK(setting.value() == "en");
+
+        CHECK(setting.accepts("  ru\n"));
+        CHECK(setting.set("  ru\n"));
+        CHECK(setting.value() == "ru");
+
+        CHECK_FALSE(setting.set("de"));
+        CHECK_FALSE(setting.set("   "));
+        CHECK(setting.value() == "ru");
+
+        setting.reset();
+        CHECK(setting.value() == "en");
+    }
+
+    SUBCASE("allowed values are matched exactly without trimming") {
+        aengine::StringSetting setting("en", true, false, allowed_values_t<std::string> { "en", "ru" });
+
+        CHECK_FALSE(setting.set(" ru"));
+        CHECK(setting.set("ru"));
+
+        CHECK_THROWS_AS(aengine::StringSetting("de", true, false, allowed_values_t<std::string> { "en", "ru" }),
+            std::invalid_argument);
+    }
+}
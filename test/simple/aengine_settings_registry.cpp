@@ -0,0 +1,202 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// ers
+#include <erslib/aengine/settings_registry.hpp>
+
+
+using aengine::impl::allowed_values_t;
+using aengine::impl::value_bounds_t;
+
+using integral = utl::Json::integral_type;
+using floating = utl::Json::floating_type;
+using string = utl::Json::string_type;
+
+
+TEST_CASE("testing aengine::SettingsRegistry") {
+    aengine::SettingsRegistry registry;
+
+    const auto vsync = registry.add("vsync", aengine::BoolSetting(true));
+    const auto fps = registry.add("fps", aengine::IntSetting(60, value_bounds_t<i64> { 30, 240 }));
+    const auto scale = registry.add("scale", aengine::DoubleSetting(1.0, value_bounds_t<f64> { 0.5, 2.0 }));
+    const auto lang = registry.add("lang", aengine::StringSetting("en", false, true, allowed_values_t<std::string> { "en", "ru" }));
+
+
+    SUBCASE("settings are found by name") {
+        CHECK(registry.find("fps") == fps);
+        CHECK(registry.find("lang") == lang);
+        CHECK_FALSE(registry.find("missing").has_value());
+
+        CHECK_THROWS_AS(registry.add("fps", aengine::IntSetting(1)), std::invalid_argument);
+        CHECK_THROWS_AS(registry.set("missing", true), std::out_of_range);
+        CHECK_THROWS_AS(registry.set(lang + 1, true), std::out_of_range);
+    }
+
+    SUBCASE("values are checked by their settings") {
+        CHECK(registry.set(fps, i64(144)));
+        CHECK(registry.set("lang", std::string(" ru ")));
+
+        CHECK_FALSE(registry.set(fps, i64(1000)));
+        CHECK_FALSE(registry.set(fps, 144.0));
+        CHECK_FALSE(registry.set(vsync, std::string("true")));
+        CHECK_FALSE(registry.set(lang, std::string("de")));
+
+        const auto snapshot = registry.snapshot();
+        CHECK(snapshot->get<i64>(fps) == 144);
+        CHECK(snapshot->get<std::string>("lang") == "ru");
+    }
+
+    SUBCASE("integral values are taken for doubles") {
+        CHECK(registry.set(scale, i64(2)));
+        CHECK(registry.snapshot()->get<f64>(scale) == 2.0);
+
+        CHECK_FALSE(registry.set("scale", i64(3)));
+        CHECK(registry.snapshot()->get<f64>(scale) == 2.0);
+    }
+
+    SUBCASE("snapshots are published on changes only") {
+        auto before = registry.snapshot();
+
+        CHECK(before->size() == 4);
+        CHECK(before->get<i64>(fps) == 60);
+
+        CHECK(registry.set(fps, i64(60)));
+        CHECK(registry.snapshot() == before);
+
+        CHECK(registry.set(fps, i64(120)));
+
+        // Taken snapshots don't change.
+        CHECK(before->get<i64>(fps) == 60);
+        CHECK(registry.snapshot()->get<i64>(fps) == 120);
+        CHECK(registry.snapshot()->version() > before->version());
+
+        const auto extra = registry.add("extra", aengine::BoolSetting(false));
+
+        CHECK_FALSE(before->find("extra").has_value());
+        CHECK(registry.snapshot()->find("extra") == extra);
+    }
+
+    SUBCASE("refresh replaces outdated snapshots only") {
+        ers::shared_ptr<const aengine::SettingsSnapshot> cached;
+
+        CHECK(registry.refresh(cached));
+        REQUIRE(cached);
+        CHECK_FALSE(registry.refresh(cached));
+
+        CHECK_FALSE(registry.set(fps, i64(1000)));
+        CHECK_FALSE(registry.refresh(cached));
+
+        CHECK(registry.set(fps, i64(90)));
+        CHECK(registry.refresh(cached));
+        CHECK(cached->get<i64>(fps) == 90);
+        CHECK_FALSE(registry.refresh(cached));
+    }
+
+    SUBCASE("reset") {
+        CHECK(registry.set(fps, i64(90)));
+        CHECK(registry.set(vsync, false));
+
+        registry.reset(fps);
+        CHECK(registry.snapshot()->get<i64>(fps) == 60);
+        CHECK_FALSE(registry.snapshot()->get<bool>(vsync));
+
+        registry.reset_all();
+        CHECK(registry.snapshot()->get<bool>(vsync));
+    }
+
+    SUBCASE("callbacks are called after changes") {
+        std::vector<std::pair<std::string, i64>> calls;
+
+        const auto subscription = registry.subscribe(fps, [&calls](std::string_view name, const aengine::setting_value_t& value) {
+            calls.emplace_back(name, std::get<i64>(value));
+        });
+
+        CHECK(registry.set(fps, i64(90)));
+        CHECK(registry.set(fps, i64(90)));
+        CHECK_FALSE(registry.set(fps, i64(1000)));
+        CHECK(registry.set(vsync, false));
+        registry.reset(fps);
+
+        REQUIRE(calls.size() == 2);
+        CHECK(calls[0] == std::pair<std::string, i64> { "fps", 90 });
+        CHECK(calls[1] == std::pair<std::string, i64> { "fps", 60 });
+
+        registry.unsubscribe(subscription);
+
+        CHECK(registry.set(fps, i64(120)));
+        CHECK(calls.size() == 2);
+    }
+
+    SUBCASE("callbacks may use the registry") {
+        i64 seen = 0;
+
+        registry.subscribe(fps, [&registry, &seen, fps](std::string_view, const aengine::setting_value_t&) {
+            seen = registry.snapshot()->get<i64>(fps);
+        });
+
+        CHECK(registry.set(fps, i64(90)));
+        CHECK(seen == 90);
+    }
+
+    SUBCASE("saved values are loaded back") {
+        CHECK(registry.set(fps, i64(144)));
+        CHECK(registry.set(scale, 1.5));
+        CHECK(registry.set(lang, std::string("ru")));
+        CHECK(registry.set(vsync, false));
+
+        auto saved = registry.save();
+
+        CHECK(saved["fps"].as<integral>() == 144);
+        CHECK(saved["scale"].as<floating>() == 1.5);
+        CHECK(saved["lang"].as<string>() == "ru");
+
+        aengine::SettingsRegistry other;
+        other.add("vsync", aengine::BoolSetting(true));
+        other.add("fps", aengine::IntSetting(60, value_bounds_t<i64> { 30, 240 }));
+        other.add("scale", aengine::DoubleSetting(1.0, value_bounds_t<f64> { 0.5, 2.0 }));
+        other.add("lang", aengine::StringSetting("en", false, true, allowed_values_t<std::string> { "en", "ru" }));
+
+        CHECK(other.load(saved).has_value());
+
+        const auto snapshot = other.snapshot();
+        CHECK_FALSE(snapshot->get<bool>("vsync"));
+        CHECK(snapshot->get<i64>("fps") == 144);
+        CHECK(snapshot->get<f64>("scale") == 1.5);
+        CHECK(snapshot->get<std::string>("lang") == "ru");
+    }
+
+    SUBCASE("loading skips unknown names and keeps rejected values") {
+        utl::Json json;
+        json["scale"] = 2;
+        json["fps"] = "fast";
+        json["lang"] = "de";
+        json["vsync"] = false;
+        json["removed"] = true;
+
+        int calls = 0;
+        registry.subscribe(scale, [&calls](std::string_view, const aengine::setting_value_t&) { calls++; });
+
+        const auto before = registry.snapshot()->version();
+
+        CHECK(registry.load(json).has_error());
+
+        // One snapshot for the whole file.
+        const auto snapshot = registry.snapshot();
+        CHECK(snapshot->version() == before + 1);
+
+        CHECK(snapshot->get<f64>(scale) == 2.0);
+        CHECK_FALSE(snapshot->get<bool>(vsync));
+        CHECK(snapshot->get<i64>(fps) == 60);
+        CHECK(snapshot->get<std::string>(lang) == "en");
+        CHECK(calls == 1);
+
+        CHECK(registry.load(utl::Json {}).has_error());
+    }
+}
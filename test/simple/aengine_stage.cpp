@@ -0,0 +1,156 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// ers
+#include <erslib/aengine/dependency_graph.hpp>
+#include <erslib/aengine/mod.hpp>
+#include <erslib/aengine/util/stage.hpp>
+#include <erslib/core/filesystem.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+namespace {
+    // Writes a mod with empty sources named "files" into "root" and reads it back.
+    aengine::Mod make_mod(
+        const fs::path& root,
+        std::string_view name,
+        std::initializer_list<std::string_view> dependencies,
+        std::initializer_list<std::string_view> files
+    ) {
+        const auto dir = root / name;
+        fs::create_directories(dir);
+
+        std::string deps;
+        for (auto dep : dependencies)
+            deps += (deps.empty() ? "\"" : ", \"") + std::string(dep) + "\"";
+
+        std::ofstream(dir / "info.json")
+            << "{ \"name\": \"" << name << "\", \"title\": \"" << name << "\", \"version\": \"1.0.0\""
+            << ", \"author\": \"test\", \"description\": \"test\", \"dependencies\": [" << deps << "] }";
+
+        for (auto file : files)
+            std::ofstream(dir / (std::string(file) + ".lua")) << "return nil";
+
+        aengine::Mod mod(dir);
+        mod.init_info();
+        mod.init_content(&aengine::util::is_stage_naming_scheme);
+        return mod;
+    }
+}
+
+
+TEST_CASE("testing aengine stage names") {
+    using aengine::util::parse_stage_name;
+
+
+    SUBCASE("valid names") {
+        auto r = parse_stage_name("data-12");
+        REQUIRE(r.has_value());
+        CHECK(r->phase == "data");
+        CHECK(r->index == 12);
+
+        r = parse_stage_name("data-final-0");
+        REQUIRE(r.has_value());
+        CHECK(r->phase == "data-final");
+        CHECK(r->index == 0);
+    }
+
+    SUBCASE("invalid names") {
+        CHECK_FALSE(parse_stage_name("data").has_value());
+        CHECK_FALSE(parse_stage_name("-1").has_value());
+        CHECK_FALSE(parse_stage_name("data-").has_value());
+        CHECK_FALSE(parse_stage_name("data-1a").has_value());
+        CHECK_FALSE(parse_stage_name("data-01").has_value());
+        CHECK_FALSE(parse_stage_name("data-00").has_value());
+    }
+
+    SUBCASE("leading zeros are told apart") {
+        using aengine::util::has_padded_stage_index;
+
+        CHECK(has_padded_stage_index("data-01"));
+        CHECK(has_padded_stage_index("data-final-007"));
+        CHECK_FALSE(has_padded_stage_index("data-0"));
+        CHECK_FALSE(has_padded_stage_index("data-10"));
+        CHECK_FALSE(has_padded_stage_index("data-0a"));
+        CHECK_FALSE(has_padded_stage_index("-01"));
+    }
+
+    SUBCASE("names are made back unchanged") {
+        for (std::string_view name : { "data-0", "data-1", "data-10", "control-final-7" }) {
+            auto r = parse_stage_name(name);
+            REQUIRE(r.has_value());
+            CHECK(aengine::util::make_stage_name(r->phase, r->index) == name);
+        }
+    }
+}
+
+
+TEST_CASE("testing aengine::resolve_stage_groups") {
+    const auto root = fs::temp_directory_path() / "aengine_stage_groups_test";
+    fs::remove_all(root);
+
+    aengine::ModContainer mods;
+    mods.emplace(make_mod(root, "base", {}, { "data-1", "data-2", "final-1" }));
+    mods.emplace(make_mod(root, "a", { "base" }, { "data-1", "final-2" }));
+    mods.emplace(make_mod(root, "b", { "a" }, { "final-1" }));
+    mods.emplace(make_mod(root, "c", {}, { "data-3" }));
+
+    aengine::DependencyGraph graph;
+    for (std::string_view name : { "base", "a", "b", "c" })
+        graph.add(*mods.find(name));
+
+    const std::vector<std::string> phases = { "data", "final" };
+    const auto groups = aengine::resolve_stage_groups(mods, graph, "base", phases);
+
+
+    SUBCASE("groups follow phases, then levels") {
+        REQUIRE(groups.size() == 5);
+
+        auto check_group = [](const aengine::stage_group_t& group, std::string_view phase,
+                              std::initializer_list<std::pair<std::string_view, std::vector<size_t>>> expected) {
+            CHECK(group.phase == phase);
+            REQUIRE(group.mods.size() == expected.size());
+
+            size_t i = 0;
+            for (const auto& [mod, indexes] : expected) {
+                CHECK(group.mods[i].mod == mod);
+                CHECK(group.mods[i].indexes == indexes);
+                i++;
+            }
+        };
+
+        check_group(groups[0], "data", { { "base", { 1, 2 } } });
+        check_group(groups[1], "data", { { "c", { 3 } }, { "a", { 1 } } });
+        check_group(groups[2], "final", { { "base", { 1 } } });
+        check_group(groups[3], "final", { { "a", { 2 } } });
+        check_group(groups[4], "final", { { "b", { 1 } } });
+    }
+
+    SUBCASE("every scheduled stage is found by its made name") {
+        for (const auto& group : groups) {
+            for (const auto& stages : group.mods) {
+                const auto& content = mods.find(stages.mod)->content();
+
+                for (size_t index : stages.indexes)
+                    CHECK(content.stages.contains(aengine::util::make_stage_name(group.phase, index)));
+            }
+        }
+    }
+
+    SUBCASE("sources named as stages with leading zeros are reported") {
+        CHECK_THROWS_AS(make_mod(root, "padded", {}, { "data-1", "data-01" }), ers::path_error);
+    }
+
+    fs::remove_all(root);
+}
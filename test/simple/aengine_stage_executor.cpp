@@ -0,0 +1,165 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// ers
+#include <erslib/aengine/stage_executor.hpp>
+#include <erslib/core/thread_safe.hpp>
+
+
+namespace fs = std::filesystem;
+
+
+namespace {
+    aengine::Mod make_mod(const fs::path& root, std::string_view name) {
+        const auto dir = root / name;
+        fs::create_directories(dir);
+
+        std::ofstream(dir / "info.json")
+            << "{ \"name\": \"" << name << "\", \"title\": \"" << name << "\", \"version\": \"1.0.0\""
+            << ", \"author\": \"test\", \"description\": \"test\", \"dependencies\": [] }";
+
+        aengine::Mod mod(dir);
+        mod.init_info();
+        return mod;
+    }
+
+    std::string stage_label(const aengine::Mod& mod, const std::string& phase, size_t index) {
+        return std::string(mod.name()) + ":" + phase + "-" + std::to_string(index);
+    }
+
+    using labels_t = std::vector<std::string>;
+}
+
+
+TEST_CASE("testing aengine::execute_stage_groups") {
+    const auto root = fs::temp_directory_path() / "aengine_stage_executor_test";
+    fs::remove_all(root);
+
+    aengine::ModContainer mods;
+    mods.emplace(make_mod(root, "a"));
+    mods.emplace(make_mod(root, "b"));
+
+    ers::thread_safe::WorkerPool pool(2);
+
+
+    SUBCASE("results are merged in the order of the group") {
+        const std::vector<aengine::stage_group_t> groups = {
+            { .phase = "data", .mods = { { .mod = "a", .indexes = { 1, 2 } }, { .mod = "b", .indexes = { 1 } } } },
+            { .phase = "final", .mods = { { .mod = "b", .indexes = { 3 } }, { .mod = "a", .indexes = { 1 } } } }
+        };
+
+        const auto caller = std::this_thread::get_id();
+        std::atomic<size_t> on_caller = 0;
+
+        labels_t merged;
+
+        aengine::execute_stage_groups(mods, groups, pool,
+            [&](const aengine::Mod& mod, const std::string& phase, size_t index) {
+                if (std::this_thread::get_id() == caller)
+                    on_caller.fetch_add(1, std::memory_order_relaxed);
+
+                // The first mod of a group finishes last.
+                if (mod.name() == (phase == "data" ? "a" : "b"))
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+                return stage_label(mod, phase, index);
+            },
+            [&](const aengine::Mod& mod, const std::string& phase, size_t index, std::string label) {
+                CHECK(std::this_thread::get_id() == caller);
+                CHECK(label == stage_label(mod, phase, index));
+                merged.push_back(std::move(label));
+            });
+
+        CHECK(merged == labels_t { "a:data-1", "a:data-2", "b:data-1", "b:final-3", "a:final-1" });
+        CHECK(on_caller.load() == 0);
+    }
+
+    SUBCASE("the first failure in group order is rethrown") {
+        const std::vector<aengine::stage_group_t> groups = {
+            { .phase = "data", .mods = { { .mod = "a", .indexes = { 1 } }, { .mod = "b", .indexes = { 1, 2 } } } },
+            { .phase = "final", .mods = { { .mod = "a", .indexes = { 1 } } } }
+        };
+
+        std::atomic<size_t> b_runs = 0;
+        std::atomic<bool> later_ran = false;
+        bool merged = false;
+
+        try {
+            aengine::execute_stage_groups(mods, groups, pool,
+                [&](const aengine::Mod& mod, const std::string& phase, size_t index) -> int {
+                    if (phase == "final")
+                        later_ran = true;
+
+                    if (mod.name() == "b") {
+                        b_runs.fetch_add(1, std::memory_order_relaxed);
+                        throw std::runtime_error("b failed");
+                    }
+
+                    // "b" fails first, but "a" is listed first.
+                    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+                    throw std::runtime_error(stage_label(mod, phase, index));
+                },
+                [&](const aengine::Mod&, const std::string&, size_t, int) {
+                    merged = true;
+                });
+
+            FAIL("failure should be rethrown");
+        } catch (const std::runtime_error& e) {
+            CHECK(std::string_view(e.what()) == "a:data-1");
+        }
+
+        // A mod stops at its first failed stage, nothing of a failed group is merged.
+        CHECK(b_runs.load() == 1);
+        CHECK_FALSE(merged);
+        CHECK_FALSE(later_ran.load());
+    }
+
+    SUBCASE("a lone mod runs on the calling thread") {
+        const std::vector<aengine::stage_group_t> groups = {
+            { .phase = "data", .mods = { { .mod = "b", .indexes = { 1, 2 } } } }
+        };
+
+        const auto caller = std::this_thread::get_id();
+        labels_t runs;
+
+        aengine::execute_stage_groups(mods, groups, pool, [&](const aengine::Mod& mod, const std::string& phase, size_t index) {
+            CHECK(std::this_thread::get_id() == caller);
+            runs.push_back(stage_label(mod, phase, index));
+        });
+
+        CHECK(runs == labels_t { "b:data-1", "b:data-2" });
+
+        CHECK_THROWS_AS(
+            aengine::execute_stage_groups(mods, groups, pool, [](const aengine::Mod&, const std::string&, size_t) {
+                throw std::runtime_error("inline");
+            }),
+            std::runtime_error);
+    }
+
+    SUBCASE("mods that aren't loaded are reported") {
+        const std::vector<aengine::stage_group_t> groups = {
+            { .phase = "data", .mods = { { .mod = "a", .indexes = { 1 } }, { .mod = "missing", .indexes = { 1 } } } }
+        };
+
+        bool ran = false;
+
+        CHECK_THROWS(aengine::execute_stage_groups(mods, groups, pool, [&ran](const aengine::Mod&, const std::string&, size_t) {
+            ran = true;
+        }));
+
+        CHECK_FALSE(ran);
+    }
+
+    fs::remove_all(root);
+}
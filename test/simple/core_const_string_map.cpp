@@ -0,0 +1,55 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <string>
+#include <string_view>
+
+// ers
+#include <erslib/core/type/const_string_map.hpp>
+
+
+namespace {
+    enum class Color {
+        Red,
+        Green,
+        Blue,
+    };
+
+    constexpr auto colors = ers::make_const_string_map<Color>({
+        { "red", Color::Red },
+        { "green", Color::Green },
+        { "blue", Color::Blue },
+    });
+
+    static_assert(colors.size() == 3);
+    static_assert(colors.at("green") == Color::Green);
+    static_assert(!colors.contains("purple"));
+}
+
+
+TEST_CASE("testing ConstStringMap") {
+    SUBCASE("runtime lookup") {
+        const std::string key = "blue";
+
+        CHECK(colors.at(key) == Color::Blue);
+        CHECK(colors.find(key)->first == "blue");
+        CHECK_FALSE(colors.contains(key.substr(1)));
+        CHECK_THROWS_AS((void) colors.at("nope"), std::out_of_range);
+    }
+
+    SUBCASE("iteration keeps construction order") {
+        std::string joined;
+        for (const auto& [name, _] : colors)
+            joined += name;
+
+        CHECK(joined == "redgreenblue");
+    }
+
+    SUBCASE("empty map") {
+        constexpr ers::ConstStringMap<int, 0> empty({});
+
+        CHECK(empty.empty());
+        CHECK(empty.find("") == empty.end());
+    }
+}
@@ -0,0 +1,216 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// ers
+#include <erslib/core/algorithm.hpp>
+#include <erslib/core/fwd.hpp>
+#include <erslib/core/hashing/rapid.hpp>
+
+
+namespace {
+    // Covers every length class of rapidhash: empty, 1-3, 4-7, 8-16 and the long paths.
+    constexpr std::array<std::string_view, 11> keys = {
+        "",
+        "a",
+        "abc",
+        "name",
+        "entity:",
+        "enemy:knight",
+        "enemy:knight:01",
+        "mod/stages/data-1.lua",
+        "a fairly long key that goes over the eighty byte threshold of the micro variant....",
+        "x",
+        "slot",
+    };
+}
+
+
+TEST_CASE("testing batched rapidhash") {
+    std::array<size_t, keys.size()> hashes;
+
+    SUBCASE("matches single-key hashing") {
+        ers::RapidHash<std::string_view> {}.hash_many(keys, hashes);
+
+        for (size_t i = 0; i < keys.size(); i++)
+            CHECK(hashes[i] == ers::RapidHash<std::string_view> {}(keys[i]));
+    }
+
+    SUBCASE("matches single-key hashing with seed") {
+        ers::RapidHash<std::string_view> {}.hash_many(keys, hashes, 42);
+
+        for (size_t i = 0; i < keys.size(); i++)
+            CHECK(hashes[i] == ers::RapidHash<std::string_view> {}(keys[i], 42));
+    }
+}
+
+
+TEST_CASE("testing bulk insert and lookup") {
+    SUBCASE("StringSet") {
+        ers::StringSet set;
+
+        CHECK(ers::algo::bulk_insert(set, keys) == keys.size());
+        CHECK(ers::algo::bulk_insert(set, keys) == 0);
+
+        std::vector<ers::StringSet::iterator> found;
+        ers::algo::bulk_find(set, keys, std::back_inserter(found));
+
+        REQUIRE(found.size() == keys.size());
+        for (size_t i = 0; i < keys.size(); i++) {
+            REQUIRE(found[i] != set.end());
+            CHECK(*found[i] == keys[i]);
+        }
+    }
+
+    SUBCASE("StringMap") {
+        ers::StringMap<size_t> map;
+
+        std::vector<std::pair<std::string_view, size_t>> items;
+        for (size_t i = 0; i < keys.size(); i++)
+            items.emplace_back(keys[i], i);
+
+        // "x" is the only duplicate, the first value wins.
+        items.emplace_back("x", 100);
+
+        CHECK(ers::algo::bulk_insert(map, items) == keys.size());
+
+        std::array<std::string_view, 2> missing = { "missing", "enemy" };
+        std::vector<ers::StringMap<size_t>::iterator> found;
+        ers::algo::bulk_find(map, missing, std::back_inserter(found));
+
+        CHECK(found[0] == map.end());
+        CHECK(found[1] == map.end());
+        CHECK(map.at("x") == 9);
+        CHECK(map.at("enemy:knight") == 5);
+    }
+}
+
+
+namespace {
+    // Pseudo-random, so misordered blocks or a lost history change the result.
+    std::string random_bytes(size_t size) {
+        std::mt19937_64 engine(0x5eed);
+        std::string result(size, '\0');
+
+        for (auto& it : result)
+            it = static_cast<char>(engine());
+
+        return result;
+    }
+
+    // Feeds "data" in pieces of the given sizes, repeating the pattern until it's over.
+    template<typename Stream>
+    size_t hash_in_pieces(std::string_view data, std::span<const size_t> pattern, size_t seed) {
+        Stream stream(seed);
+
+        for (size_t i = 0; !data.empty(); i++) {
+            const size_t piece = std::min(pattern[i % pattern.size()], data.size());
+            stream.update(data.substr(0, piece));
+            data.remove_prefix(piece);
+        }
+
+        return stream.finalize();
+    }
+
+    template<typename Stream, template<typename> typename Hash>
+    void check_stream_variant(std::string_view data, size_t block_size) {
+        const std::vector<std::vector<size_t>> patterns = {
+            { 1 },
+            { block_size },
+            { block_size - 1 },
+            { block_size + 1 },
+            { block_size - 16, 32 },
+            { 7, block_size * 2 + 3, 1, 16 },
+            { 3, 5, 11, 64, 200 }
+        };
+
+        for (size_t size : { size_t(0), size_t(15), size_t(16), block_size - 1, block_size, block_size + 1,
+                 block_size + 16, block_size * 2, block_size * 3 + 17, data.size() }) {
+            const auto view = data.substr(0, size);
+
+            for (const auto& pattern : patterns) {
+                CHECK(hash_in_pieces<Stream>(view, pattern, 0) == Hash<std::string_view> {}(view));
+                CHECK(hash_in_pieces<Stream>(view, pattern, 42) == Hash<std::string_view> {}(view, 42));
+            }
+        }
+    }
+}
+
+
+TEST_CASE("testing incremental rapidhash") {
+    const std::string data = random_bytes(2000);
+
+    // Blocks are 16-byte lanes: 3 for nano, 5 for micro, 7 for full and unrolled.
+
+    SUBCASE("micro matches one-shot hashing for every split pattern") {
+        check_stream_variant<ers::RapidHashStream, ers::RapidHash>(data, 5 * 16);
+    }
+
+    SUBCASE("nano matches one-shot hashing for every split pattern") {
+        check_stream_variant<ers::RapidNanoHashStream, ers::RapidNanoHash>(data, 3 * 16);
+    }
+
+    SUBCASE("full matches one-shot hashing for every split pattern") {
+        check_stream_variant<ers::RapidFullHashStream, ers::RapidFullHash>(data, 7 * 16);
+    }
+
+    SUBCASE("unrolled matches one-shot hashing for every split pattern") {
+        check_stream_variant<ers::RapidUnrolledHashStream, ers::RapidUnrolledHash>(data, 7 * 16);
+    }
+
+    SUBCASE("every single split point") {
+        const std::string_view view = std::string_view(data).substr(0, 300);
+
+        for (size_t split = 0; split <= view.size(); split++) {
+            ers::RapidFullHashStream full;
+            full.update(view.substr(0, split)).update(view.substr(split));
+            CHECK(full.finalize() == ers::RapidFullHash<std::string_view> {}(view));
+
+            ers::RapidHashStream micro;
+            micro.update(view.substr(0, split)).update(view.substr(split));
+            CHECK(micro.finalize() == ers::RapidHash<std::string_view> {}(view));
+        }
+    }
+
+    SUBCASE("short input") {
+        ers::RapidHashStream stream;
+        stream.update("ab").update("c");
+        CHECK(stream.finalize() == ers::RapidHash<std::string_view> {}("abc"));
+    }
+
+    SUBCASE("combine keeps argument boundaries") {
+        CHECK(ers::algo::combine<ers::RapidHash>(std::string_view("ab"), std::string_view("c"))
+            != ers::algo::combine<ers::RapidHash>(std::string_view("a"), std::string_view("bc")));
+        CHECK(ers::algo::combine<ers::RapidHash>(size_t(1), size_t(2))
+            != ers::algo::combine<ers::RapidHash>(size_t(2), size_t(1)));
+    }
+
+    SUBCASE("combine is usable in constant expressions") {
+        constexpr size_t combined = ers::algo::combine<ers::RapidHash>(std::string_view("entity"), size_t(7));
+
+        static_assert(combined != ers::algo::combine<ers::RapidHash>(std::string_view("entit"), std::string_view("y"), size_t(7)));
+        static_assert(noexcept(ers::algo::combine<ers::RapidHash>(std::string_view("entity"), size_t(7))));
+
+        // Constant evaluation takes another path for strings, the value must not change.
+        const std::string_view name = "entity";
+        CHECK(ers::algo::combine<ers::RapidHash>(name, size_t(7)) == combined);
+
+        constexpr auto streamed = [] {
+            ers::RapidHashStream stream;
+            stream.update("ab").update("c");
+            return stream.finalize();
+        }();
+
+        CHECK(streamed == ers::RapidHash<std::string_view> {}("abc"));
+    }
+}
@@ -4,14 +4,39 @@
 // std
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <memory>
+#include <memory_resource>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 // ers
+#include <erslib/core/filesystem.hpp>
 #include <erslib/core/memory.hpp>
 #include <erslib/core/type/general.hpp>
 
 
 namespace {
+    struct Shape {
+        virtual ~Shape() = default;
+        virtual f64 area() const = 0;
+    };
+
+    struct Rect : Shape {
+        f64 w, h;
+
+        Rect(f64 w, f64 h) :
+            w(w),
+            h(h) {
+        }
+
+        f64 area() const override { return w * h; }
+    };
+
     struct Position {
         f64 x, y;
 
@@ -20,6 +45,18 @@ namespace {
             y(y) {
         }
     };
+
+
+    // Checking copyability of these asks about the copy of an incomplete "TFunction".
+    struct Task {
+        i32 priority;
+        ers::move_only_function<void()> fn;
+    };
+
+    struct Callback {
+        i32 id;
+        ers::function<void()> fn;
+    };
 }
 
 
@@ -38,3 +75,168 @@ TEST_CASE("testing custom allocator") {
         REQUIRE(position);
     }
 }
+
+
+TEST_CASE("testing size class resource") {
+    auto* mr = ers::size_class_resource();
+
+    SUBCASE("blocks are reused") {
+        void* first = mr->allocate(40);
+        mr->deallocate(first, 40);
+
+        void* second = mr->allocate(64);
+        CHECK(first == second);
+        mr->deallocate(second, 64);
+    }
+
+    SUBCASE("big and over-aligned requests") {
+        void* big = mr->allocate(1000);
+        void* aligned = mr->allocate(32, 128);
+
+        CHECK(reinterpret_cast<uintptr_t>(aligned) % 128 == 0);
+
+        mr->deallocate(big, 1000);
+        mr->deallocate(aligned, 32, 128);
+    }
+
+    SUBCASE("holders") {
+        auto position = ers::make_pooled_holder<Position>(1.0, 2.0);
+        auto shape = ers::make_pooled_polymorphic_holder<Shape, Rect>(2.0, 3.0);
+
+        CHECK(position->y == 2.0);
+        CHECK(shape->area() == 6.0);
+    }
+
+    SUBCASE("blocks freed on another thread") {
+        std::vector<ers::holder_ptr<Position>> positions;
+        for (size_t i = 0; i < 1000; i++)
+            positions.push_back(ers::make_pooled_holder<Position>(1.0, 2.0));
+
+        std::jthread([&positions] { positions.clear(); }).join();
+
+        CHECK(ers::make_pooled_holder<Position>(3.0, 4.0)->x == 3.0);
+    }
+}
+
+
+TEST_CASE("testing scratch arena") {
+    ers::ScratchArena arena;
+
+    SUBCASE("checkpoints rewind") {
+        {
+            auto scope = arena.checkpoint();
+            std::pmr::vector<int> temp({ 1, 2, 3 }, &arena);
+
+            CHECK(arena.used() >= 3 * sizeof(int));
+        }
+
+        CHECK(arena.used() == 0);
+    }
+
+    SUBCASE("blocks are reused") {
+        void* first;
+        {
+            auto scope = arena.checkpoint();
+            first = arena.allocate(100000);
+        }
+
+        const size_t capacity = arena.capacity();
+        {
+            auto scope = arena.checkpoint();
+            CHECK(arena.allocate(100000) == first);
+        }
+
+        CHECK(arena.capacity() == capacity);
+    }
+
+    SUBCASE("alignment") {
+        auto scope = arena.checkpoint();
+
+        [[maybe_unused]] void* padding = arena.allocate(1, 1);
+        void* aligned = arena.allocate(16, 64);
+
+        CHECK(reinterpret_cast<uintptr_t>(aligned) % 64 == 0);
+    }
+}
+
+TEST_CASE("testing mapped file") {
+    const auto path = fs::temp_directory_path() / "erslib_mapped_file_test.bin";
+
+    SUBCASE("contents") {
+        std::ofstream(path, std::ios::binary) << "mapped contents";
+
+        ers::MappedFile file(path);
+        auto moved = std::move(file);
+
+        CHECK(file.empty());
+        CHECK(moved.view() == "mapped contents");
+    }
+
+    SUBCASE("empty file") {
+        std::ofstream(path, std::ios::binary | std::ios::trunc).flush();
+
+        ers::MappedFile file(path);
+
+        CHECK(file.empty());
+        CHECK(file.data() == nullptr);
+    }
+
+    SUBCASE("missing file") {
+        fs::remove(path);
+        CHECK_THROWS_AS(ers::MappedFile(path), ers::path_error);
+    }
+
+    fs::remove(path);
+}
+
+TEST_CASE("testing ers::function") {
+    SUBCASE("inline and heap callables") {
+        ers::function<size_t(size_t)> small = [s = std::string("abc")](size_t x) { return x + s.size(); };
+        ers::function<size_t(size_t), 16> big = [s = std::string("abc")](size_t x) { return x + s.size(); };
+
+        auto small_copy = small;
+        auto big_copy = big;
+        auto big_moved = std::move(big);
+
+        CHECK(small(1) == 4);
+        CHECK(small_copy(2) == 5);
+        CHECK(big_copy(3) == 6);
+        CHECK(big_moved(4) == 7);
+        CHECK_FALSE(big);
+    }
+
+    SUBCASE("move-only callables") {
+        ers::move_only_function<int()> f = [p = std::make_unique<int>(7)] { return *p; };
+        auto g = std::move(f);
+
+        CHECK_FALSE(f);
+        CHECK(g() == 7);
+    }
+
+    SUBCASE("classes holding functions") {
+        static_assert(!std::is_copy_constructible_v<Task>);
+        static_assert(std::is_nothrow_move_constructible_v<Task>);
+        static_assert(std::is_copy_constructible_v<Callback>);
+
+        i32 calls = 0;
+
+        std::vector<Task> tasks;
+        tasks.push_back({ 1, [&calls] { calls++; } });
+        tasks.resize(4);
+
+        std::vector<Callback> callbacks = { { 1, [&calls] { calls += 10; } } };
+        auto copies = callbacks;
+
+        tasks.front().fn();
+        copies.front().fn();
+
+        CHECK(calls == 11);
+        CHECK_FALSE(tasks.back().fn);
+    }
+
+    SUBCASE("empty call throws") {
+        ers::function<void()> f;
+        CHECK(f == nullptr);
+        CHECK_THROWS_AS(f(), std::bad_function_call);
+    }
+}
@@ -0,0 +1,266 @@
+// doctest
+#include <doctest/doctest.h>
+
+// std
+#include <atomic>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// ers
+#include <erslib/core/fwd.hpp>
+#include <erslib/core/exception.hpp>
+#include <erslib/core/thread_safe.hpp>
+
+
+namespace {
+    // Message of the error "operator[]" throws for "key".
+    template<typename M, typename K>
+    std::string missing_key_error(const M& map, const K& key) {
+        try {
+            (void) map[key];
+        } catch (const std::out_of_range& e) {
+            return e.what();
+        }
+
+        return {};
+    }
+}
+
+
+TEST_CASE("testing thread_safe::ShardedMap") {
+    ers::thread_safe::ShardedMap<ers::StringMap<size_t>> map;
+
+    constexpr size_t threads = 4;
+    constexpr size_t per_thread = 1000;
+
+
+    SUBCASE("concurrent set and get") {
+        std::vector<std::jthread> workers;
+
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&map, t] {
+                for (size_t i = 0; i < per_thread; i++) {
+                    const size_t value = t * per_thread + i;
+                    map.set(std::to_string(value), value);
+                    (void) map.get(std::to_string(value / 2));
+                }
+            });
+        }
+
+        workers.clear();
+
+        CHECK(map.size() == threads * per_thread);
+        for (size_t value = 0; value < threads * per_thread; value++)
+            CHECK(map[std::to_string(value)] == value);
+    }
+
+    SUBCASE("existing keys are kept") {
+        CHECK(map.set("key", 1));
+        CHECK_FALSE(map.set("key", 2));
+        CHECK(map.get("key") == 1);
+        CHECK_FALSE(map.get("missing").has_value());
+    }
+
+    SUBCASE("erase and clear") {
+        map.set("a", 1);
+        map.set("b", 2);
+
+        CHECK(map.erase("a"));
+        CHECK_FALSE(map.erase("a"));
+        CHECK(map.size() == 1);
+
+        map.clear();
+        CHECK(map.empty());
+    }
+
+    SUBCASE("operator[] names missing keys") {
+        map.set("key", 1);
+
+        CHECK(map["key"] == 1);
+        CHECK_THROWS_AS((void) map["missing"], ers::out_of_range_error);
+        CHECK(missing_key_error(map, std::string_view("missing")).find("'missing'") != std::string::npos);
+    }
+}
+
+
+TEST_CASE("testing thread_safe::SnapshotMap") {
+    ers::thread_safe::SnapshotMap<ers::StringMap<std::string>> map;
+
+    SUBCASE("pinned values outlive later writes") {
+        map.set("query", "select 1");
+        auto pinned = map.get("query");
+        const auto before = map.snapshot();
+
+        map.update([](auto& data) {
+            data.clear();
+            data.emplace("other", "select 2");
+        });
+
+        REQUIRE(pinned);
+        CHECK(*pinned == "select 1");
+        CHECK(before->size() == 1);
+        CHECK_FALSE(map.get("query"));
+        CHECK(*map.get("other") == "select 2");
+    }
+
+    SUBCASE("reader follows published versions") {
+        auto reader = map.reader();
+        CHECK(reader.find("key") == nullptr);
+
+        map.set("key", "value");
+        REQUIRE(reader.find("key") != nullptr);
+        CHECK(*reader.find("key") == "value");
+    }
+
+    SUBCASE("concurrent readers and a writer") {
+        std::vector<std::jthread> workers;
+        std::atomic<size_t> wrong_values = 0;
+        std::atomic<size_t> shrunk = 0;
+
+        for (size_t t = 0; t < 4; t++) {
+            workers.emplace_back([&map, &wrong_values, &shrunk] {
+                auto reader = map.reader();
+                size_t last_size = 0;
+
+                for (size_t i = 0; i < 1000; i++) {
+                    const auto key = std::to_string(i % 100);
+
+                    if (const auto* value = reader.find(key); value && *value != key)
+                        wrong_values++;
+
+                    // Versions are only ever published forward, so a reader can't see the map shrink.
+                    const size_t size = reader.refresh().size();
+                    if (size < last_size)
+                        shrunk++;
+
+                    last_size = size;
+                }
+            });
+        }
+
+        for (size_t i = 0; i < 100; i++)
+            map.set(std::to_string(i), std::to_string(i));
+
+        workers.clear();
+        CHECK(wrong_values == 0);
+        CHECK(shrunk == 0);
+        CHECK(map.size() == 100);
+    }
+}
+
+
+TEST_CASE("testing thread_safe::Map borrowed access") {
+    ers::thread_safe::Map<ers::StringMap<std::string>> map;
+    map.set("key", "value");
+
+    SUBCASE("get_copy") {
+        CHECK(map.get_copy("key") == std::string("value"));
+        CHECK_FALSE(map.get_copy("missing").has_value());
+    }
+
+    SUBCASE("visit") {
+        size_t length = 0;
+
+        CHECK(map.visit("key", [&length](const std::string& v) { length = v.size(); }));
+        CHECK(length == 5);
+        CHECK_FALSE(map.visit("missing", [](const std::string&) {}));
+    }
+
+    SUBCASE("pin") {
+        {
+            auto pinned = map.pin("key");
+            REQUIRE(pinned);
+            CHECK(*pinned == "value");
+            CHECK(pinned->size() == 5);
+        }
+
+        CHECK_FALSE(map.pin("missing"));
+        CHECK(map.set("other", "value"));
+    }
+
+    SUBCASE("operator[] throws on missing keys") {
+        CHECK(map["key"] == "value");
+        CHECK_THROWS_AS((void) map["missing"], std::out_of_range);
+        CHECK(missing_key_error(map, "missing").find("'missing'") != std::string::npos);
+    }
+}
+
+
+TEST_CASE("testing thread_safe batched I/O") {
+    std::vector<std::pair<std::string, size_t>> items = { { "a", 1 }, { "b", 2 }, { "a", 3 } };
+    const std::vector<std::string> keys = { "b", "missing", "a" };
+
+    SUBCASE("Map") {
+        ers::thread_safe::Map<ers::StringMap<size_t>> map;
+        map.reserve(16);
+
+        CHECK(map.set_many(items) == 2);
+        CHECK(map["a"] == 1);
+
+        std::vector<ers::optional<size_t>> found;
+        CHECK(map.get_many(keys, std::back_inserter(found)) == 2);
+        CHECK(found[0] == 2);
+        CHECK_FALSE(found[1].has_value());
+        CHECK(found[2] == 1);
+    }
+
+    SUBCASE("ShardedMap") {
+        ers::thread_safe::ShardedMap<ers::StringMap<size_t>> map;
+        map.reserve(16);
+
+        CHECK(map.set_many(items) == 2);
+        CHECK(map["a"] == 1);
+
+        std::vector<ers::optional<size_t>> found(keys.size());
+        CHECK(map.get_many(keys, found.begin()) == 2);
+        CHECK(found[0] == 2);
+        CHECK_FALSE(found[1].has_value());
+        CHECK(found[2] == 1);
+    }
+}
+
+
+TEST_CASE("testing thread_safe::WorkerPool") {
+    SUBCASE("futures") {
+        ers::thread_safe::WorkerPool pool(4);
+        std::vector<std::future<size_t>> results;
+
+        for (size_t i = 0; i < 100; i++)
+            results.push_back(pool.submit([i] { return i * 2; }));
+
+        for (size_t i = 0; i < 100; i++)
+            CHECK(results[i].get() == i * 2);
+    }
+
+    SUBCASE("priorities and cancellation") {
+        std::promise<void> gate;
+        std::vector<int> order;
+
+        {
+            ers::thread_safe::WorkerPool pool(1);
+
+            // Holds the only worker, so the rest is queued before anything runs.
+            pool.post([gate = gate.get_future().share()](std::stop_token) { gate.wait(); });
+
+            pool.post([&order](std::stop_token) { order.push_back(0); }, ers::thread_safe::TaskPriority::Low);
+            pool.post([&order](std::stop_token) { order.push_back(1); });
+            pool.post([&order](std::stop_token) { order.push_back(2); }, ers::thread_safe::TaskPriority::High);
+
+            auto stop = pool.post([&order](std::stop_token token) {
+                order.push_back(token.stop_requested() ? -1 : 3);
+            });
+            stop.request_stop();
+
+            gate.set_value();
+            pool.wait_idle();
+        }
+
+        CHECK(order == std::vector { 2, 1, -1, 0 });
+    }
+}